@@ -0,0 +1,194 @@
+import std;
+import PotatoReg;
+
+using namespace Potato::Reg;
+
+// Output is csv, one row for each (family, mode, table, input size) :
+// family,pattern_count,mode,table,input_bytes,build_us,table_bytes,match_count,mb_per_s,status
+// mode is search for the unanchored table driven by FindAll, and scan for the anchored HeadMatch table driven by ScanProcess,
+// so a family which the unanchored construction rejects (such as counted repetition) still gets measured.
+// table_bytes is only filled for the binary table, the other tables have no flat size to compare with.
+
+struct PatternFamily
+{
+	std::string_view Name;
+	std::vector<std::u8string_view> Patterns;
+};
+
+std::vector<PatternFamily> const& GetFamilies()
+{
+	static std::vector<PatternFamily> Families = {
+		{ "literal", { u8"while", u8"return", u8"template" } },
+		{ "class", { u8"[a-zA-Z_][a-zA-Z0-9_]*", u8"[0-9]+" } },
+		{ "alternation", { u8"if|else|while|for|return|break|continue|switch|case|default" } },
+		{ "counter", { u8"[0-9]{4}-[0-9]{2}-[0-9]{2}", u8"x{2,5}" } },
+		{ "capture", { u8R"(([a-z]+)@([a-z]+)\.com)", u8R"((\d+)\.(\d+))" } },
+	};
+	return Families;
+}
+
+std::u8string CreateInput(std::size_t Size)
+{
+	static constexpr std::array<std::u8string_view, 16> Words = {
+		u8"while", u8"foo", u8"return", u8"bar_1", u8"2024-01-31", u8"12.5", u8"xxx", u8"template",
+		u8"mail@host.com", u8"if", u8"else", u8"(", u8")", u8"+", u8"Value", u8"switch"
+	};
+
+	std::mt19937 Engine(20240131);
+	std::u8string Result;
+	Result.reserve(Size + 16);
+	while (Result.size() < Size)
+	{
+		Result += Words[Engine() % Words.size()];
+		Result += (Engine() % 8 == 0) ? u8'\n' : u8' ';
+	}
+	Result.resize(Size);
+	return Result;
+}
+
+struct ResultT
+{
+	std::size_t MatchCount = 0;
+	double MBPerSecond = 0.0;
+};
+
+enum class ModeE
+{
+	Search,
+	Scan,
+};
+
+std::string_view GetModeName(ModeE Mode)
+{
+	return Mode == ModeE::Search ? "search" : "scan";
+}
+
+template<typename TableT>
+ResultT Measure(ModeE Mode, TableT const& Table, std::u8string_view Input)
+{
+	static constexpr std::size_t MinTotalBytes = std::size_t(16) * 1024 * 1024;
+
+	DfaProcessor Processor;
+	Processor.SetObserverTable(Table);
+
+	std::size_t Repeat = std::max(std::size_t(3), MinTotalBytes / std::max(Input.size(), std::size_t(1)));
+	ResultT Result;
+
+	auto Start = std::chrono::steady_clock::now();
+	for (std::size_t Ite = 0; Ite < Repeat; ++Ite)
+	{
+		std::size_t Count = 0;
+		if (Mode == ModeE::Search)
+		{
+			for ([[maybe_unused]] auto& Ite2 : Processor.FindAll(Input))
+				++Count;
+		}
+		else {
+			std::size_t Offset = 0;
+			while (Offset < Input.size())
+			{
+				auto Accept = Processor.ScanProcess(Input, Offset);
+				if (!Accept)
+					break;
+				++Count;
+				// the input is ASCII, so stepping one byte past an empty match stays on a code point
+				Offset = std::max(Accept.GetMainCapture().End(), Offset + 1);
+			}
+		}
+		Result.MatchCount = Count;
+	}
+	auto End = std::chrono::steady_clock::now();
+
+	auto Seconds = std::chrono::duration<double>(End - Start).count();
+	if (Seconds > 0.0)
+		Result.MBPerSecond = static_cast<double>(Input.size() * Repeat) / (1024.0 * 1024.0) / Seconds;
+	return Result;
+}
+
+void PrintRow(PatternFamily const& Family, ModeE Mode, std::string_view Table, std::size_t InputBytes, std::int64_t BuildUs, std::optional<std::size_t> TableBytes, ResultT const& Result, std::string_view Status)
+{
+	std::cout << std::format("{},{},{},{},{},{},{},{},{:.2f},{}\n", Family.Name, Family.Patterns.size(), GetModeName(Mode), Table, InputBytes, BuildUs,
+		TableBytes.has_value() ? std::to_string(*TableBytes) : std::string{}, Result.MatchCount, Result.MBPerSecond, Status);
+}
+
+void RunMode(PatternFamily const& Family, ModeE Mode, std::span<std::u8string const> Inputs)
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::optional<Dfa> Table;
+	std::optional<Dfa> ClassTable;
+	std::vector<DfaBinaryTableWrapper::StandardT> Binary;
+	std::int64_t BuildUs = 0;
+	std::int64_t ClassBuildUs = 0;
+	std::int64_t BinaryBuildUs = 0;
+
+	try
+	{
+		auto Start = Clock::now();
+		MulityRegCreater Creater;
+		std::size_t Mask = 0;
+		for (auto Ite : Family.Patterns)
+			Creater.AppendReg(Ite, false, Mask++);
+		if (Mode == ModeE::Search)
+			Table = Creater.CreateUnanchoredDfa(Dfa::FormatE::HeadMatch);
+		else
+			Table = Creater.CreateDfa(Dfa::FormatE::HeadMatch);
+		auto DfaEnd = Clock::now();
+
+		ClassTable.emplace(*Table);
+		ClassTable->BuildClassTable();
+		auto ClassEnd = Clock::now();
+
+		Binary = CreateDfaBinaryTable(*ClassTable);
+		auto BinaryEnd = Clock::now();
+
+		BuildUs = std::chrono::duration_cast<std::chrono::microseconds>(DfaEnd - Start).count();
+		ClassBuildUs = BuildUs + std::chrono::duration_cast<std::chrono::microseconds>(ClassEnd - DfaEnd).count();
+		BinaryBuildUs = ClassBuildUs + std::chrono::duration_cast<std::chrono::microseconds>(BinaryEnd - ClassEnd).count();
+	}
+	catch (std::exception const&)
+	{
+		for (auto& Ite : Inputs)
+			PrintRow(Family, Mode, "Dfa", Ite.size(), 0, std::nullopt, {}, "build_error");
+		return;
+	}
+
+	auto BinaryBytes = Binary.size() * sizeof(DfaBinaryTableWrapper::StandardT);
+	DfaBinaryTableWrapper Wrapper{ std::span(Binary) };
+
+	for (auto& Ite : Inputs)
+	{
+		std::u8string_view Input = Ite;
+		PrintRow(Family, Mode, "Dfa", Input.size(), BuildUs, std::nullopt, Measure(Mode, *Table, Input), "ok");
+		PrintRow(Family, Mode, "DfaClassTable", Input.size(), ClassBuildUs, std::nullopt, Measure(Mode, *ClassTable, Input), "ok");
+		PrintRow(Family, Mode, "DfaBinaryTableWrapper", Input.size(), BinaryBuildUs, BinaryBytes, Measure(Mode, Wrapper, Input), "ok");
+	}
+}
+
+void RunFamily(PatternFamily const& Family, std::span<std::u8string const> Inputs)
+{
+	RunMode(Family, ModeE::Search, Inputs);
+	RunMode(Family, ModeE::Scan, Inputs);
+}
+
+int main(int argc, char const* argv[])
+{
+	std::vector<std::size_t> Sizes = { 4 * 1024, 256 * 1024, 4 * 1024 * 1024 };
+
+	// the input sizes in byte can be overridden from the command line, e.g. ZBench_Reg 1024 65536
+	if (argc > 1)
+	{
+		Sizes.clear();
+		for (int Ite = 1; Ite < argc; ++Ite)
+			Sizes.push_back(static_cast<std::size_t>(std::stoull(argv[Ite])));
+	}
+
+	std::vector<std::u8string> Inputs;
+	for (auto Ite : Sizes)
+		Inputs.push_back(CreateInput(Ite));
+
+	std::cout << "family,pattern_count,mode,table,input_bytes,build_us,table_bytes,match_count,mb_per_s,status\n";
+	for (auto& Ite : GetFamilies())
+		RunFamily(Ite, Inputs);
+	return 0;
+}
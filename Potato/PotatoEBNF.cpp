@@ -99,6 +99,7 @@ namespace Potato::EBNF
 			StartupTable.Link(Reg::Nfa{ std::basic_string_view{UR"(//[^\n]*\n)"}, false,static_cast<std::size_t>(T::Command) });
 
 			Reg::Dfa FinalTable(Reg::Dfa::FormatE::GreedyHeadMatch, StartupTable);
+			FinalTable.BuildClassTable();
 			return Reg::CreateDfaBinaryTable(FinalTable);
 		}();
 
@@ -764,6 +765,7 @@ namespace Potato::EBNF
 			}
 
 			Lexical = *Gen.CreateDfa(Reg::Dfa::FormatE::GreedyHeadMatch);
+			Lexical.BuildClassTable();
 
 			SLRX::Symbol StartSymbol;
 
@@ -1018,6 +1020,18 @@ namespace Potato::EBNF
 		return Buffer;
 	}
 
+	std::vector<EbnfBinaryTableWrapper::StandardT> CreateEbnfBinaryContainer(Ebnf const& Table)
+	{
+		return Misc::BinaryTableContainer::Create(EbnfBinaryTableWrapper::ContainerTag, EbnfBinaryTableWrapper::ContainerVersion, CreateEbnfBinaryTable(Table));
+	}
+
+	std::optional<EbnfBinaryTableWrapper> EbnfBinaryTableWrapper::FromContainer(std::span<StandardT const> Buffer, bool VerifyChecksum)
+	{
+		if (Misc::BinaryTableContainer::Check(Buffer, ContainerTag, ContainerVersion, VerifyChecksum) != Misc::BinaryTableContainer::CheckResultE::Ok)
+			return std::nullopt;
+		return EbnfBinaryTableWrapper{ Misc::BinaryTableContainer::GetTable(Buffer) };
+	}
+
 
 	std::tuple<SymbolInfo, std::size_t> EbnfProcessor::Tranlate(std::size_t Mask, Misc::IndexSpan<> TokenIndex) const
 	{
@@ -1068,6 +1082,8 @@ namespace Potato::EBNF
 		SyntaxProcessor.SetObserverTable(Table.Syntax, {&EbnfProcessor::HandleReduce, this });
 		LastSymbolTokenIndex = StartupTokenIndex;
 		RequireTokenIndex = StartupTokenIndex;
+		StartupIndex = StartupTokenIndex;
+		SnapshotTokenIndex.clear();
 	}
 
 	void EbnfProcessor::SetObserverTable(EbnfBinaryTableWrapper Table, HandleSymbolFuncT HandleSymbol, HandleReduceFuncT HandleReduce, std::size_t StartupTokenIndex)
@@ -1077,17 +1093,42 @@ namespace Potato::EBNF
 		TableWrapper = Table;
 		LexicalProcessor.SetObserverTable(Table.GetLexicalTable());
 		SyntaxProcessor.SetObserverTable(Table.GetSyntaxTable(), { &EbnfProcessor::HandleReduce, this });
-		StartupTokenIndex = StartupTokenIndex;
+		LastSymbolTokenIndex = StartupTokenIndex;
 		RequireTokenIndex = StartupTokenIndex;
+		StartupIndex = StartupTokenIndex;
+		SnapshotTokenIndex.clear();
 	}
 
 	void EbnfProcessor::Clear(std::size_t Startup) {
 		LastSymbolTokenIndex = Startup;
 		RequireTokenIndex = Startup;
+		StartupIndex = Startup;
+		SnapshotTokenIndex.clear();
 		LexicalProcessor.Clear();
 		SyntaxProcessor.Clear();
 	}
 
+	std::size_t EbnfProcessor::RestoreBefore(std::size_t EditBegin)
+	{
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		// the lexer may read past the end of a terminal symbol before accepting it, so the whole read span must be before the edit
+		std::size_t Count = SnapshotTokenIndex.size();
+		while (Count > 0 && SnapshotTokenIndex[Count - 1].End() > EditBegin)
+			--Count;
+		SnapshotTokenIndex.resize(Count);
+		SyntaxProcessor.RestoreSnapshot(Count);
+		LastSymbolTokenIndex = (Count == 0 ? StartupIndex : SnapshotTokenIndex[Count - 1].Begin());
+		RequireTokenIndex = LastSymbolTokenIndex;
+		LexicalProcessor.Clear();
+		return RequireTokenIndex;
+	}
+
+	void EbnfProcessor::RecordSnapshot(Misc::IndexSpan<> LexicalSpan)
+	{
+		while (SnapshotTokenIndex.size() < SyntaxProcessor.GetSnapshots().size())
+			SnapshotTokenIndex.push_back(LexicalSpan);
+	}
+
 	bool EbnfProcessor::Consume(char32_t Value, std::size_t NextTokenIndex)
 	{
 		assert(!std::holds_alternative<std::monostate>(TableWrapper));
@@ -1107,6 +1148,7 @@ namespace Potato::EBNF
 				bool Re = AddTerminalSymbol(*Accept.Mask, Capture);
 				if (Re)
 				{
+					RecordSnapshot({ MainCapture.End(), NextTokenIndex });
 					RequireTokenIndex = Accept.GetMainCapture().End();
 					LastSymbolTokenIndex = RequireTokenIndex;
 					LexicalProcessor.Clear();
@@ -1135,6 +1177,7 @@ namespace Potato::EBNF
 				bool Re = AddTerminalSymbol(*Accept.Mask, Capture);
 				if (Re)
 				{
+					RecordSnapshot({ MainCapture.End(), RequireTokenIndex });
 					if (MainCapture.End() == RequireTokenIndex)
 					{
 						if (TerminalEndOfFile())
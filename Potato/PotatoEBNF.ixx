@@ -219,6 +219,9 @@ export namespace Potato::EBNF
 	{
 		using StandardT = std::uint32_t;
 
+		static constexpr StandardT ContainerTag = 0x46424E45;
+		static constexpr StandardT ContainerVersion = 1;
+
 		struct HeadT
 		{
 			StandardT TotalNameOffset = 0;
@@ -247,6 +250,9 @@ export namespace Potato::EBNF
 		EbnfBinaryTableWrapper() = default;
 		EbnfBinaryTableWrapper(std::span<StandardT const> Buffer) : Buffer(Buffer) {}
 
+		// Buffer is created by CreateEbnfBinaryContainer, return nullopt if it fails the BinaryTableContainer::Check.
+		static std::optional<EbnfBinaryTableWrapper> FromContainer(std::span<StandardT const> Buffer, bool VerifyChecksum = false);
+
 		Ebnf::RegInfoT GetRgeInfo(std::size_t Index) const;
 		std::u8string_view GetRegName(std::size_t Index) const;
 		Reg::DfaBinaryTableWrapper GetLexicalTable() const;
@@ -262,6 +268,7 @@ export namespace Potato::EBNF
 	};
 
 	std::vector<EbnfBinaryTableWrapper::StandardT> CreateEbnfBinaryTable(Ebnf const& Table);
+	std::vector<EbnfBinaryTableWrapper::StandardT> CreateEbnfBinaryContainer(Ebnf const& Table);
 
 	struct EbnfProcessor
 	{
@@ -281,8 +288,15 @@ export namespace Potato::EBNF
 		void SetObserverTable(Ebnf const& Table, HandleSymbolFuncT HandleSymbol = {}, HandleReduceFuncT HandleReduce = {}, std::size_t StartupTokenIndex = 0);
 		void SetObserverTable(EbnfBinaryTableWrapper Table, HandleSymbolFuncT HandleSymbol = {}, HandleReduceFuncT HandleReduce = {}, std::size_t StartupTokenIndex = 0);
 
+		// take a snapshot of the syntax processor every Interval terminal symbols, 0 to disable.
+		void SetSnapshotInterval(std::size_t Interval) { SyntaxProcessor.SetSnapshotInterval(Interval); }
+
+		// for incremental reparse, restore the latest snapshot whose terminal symbols and lexical lookahead end before EditBegin,
+		// return the token index which the lexer restarts from, Process feeds the edited string again from there.
+		std::size_t RestoreBefore(std::size_t EditBegin);
+
 		EbnfProcessor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
-			: LexicalProcessor(resource), SyntaxProcessor(resource), TempElement(resource) {}
+			: LexicalProcessor(resource), SyntaxProcessor(resource), TempElement(resource), SnapshotTokenIndex(resource) {}
 
 	protected:
 
@@ -291,6 +305,7 @@ export namespace Potato::EBNF
 
 		bool AddTerminalSymbol(std::size_t RegIndex, Misc::IndexSpan<> TokenIndex);
 		bool TerminalEndOfFile();
+		void RecordSnapshot(Misc::IndexSpan<> LexicalSpan);
 		std::any HandleReduce(SLRX::SymbolInfo Value, SLRX::ReduceProduction Desc);
 
 		std::variant<
@@ -308,6 +323,9 @@ export namespace Potato::EBNF
 		std::pmr::vector<ReduceProduction::Element> TempElement;
 		std::size_t RequireTokenIndex = 0;
 		std::size_t LastSymbolTokenIndex = 0;
+		std::size_t StartupIndex = 0;
+		// for each snapshot of SyntaxProcessor, Begin is the end of its last terminal symbol and End is the end of the characters read by the lexer
+		std::pmr::vector<Misc::IndexSpan<>> SnapshotTokenIndex;
 	};
 
 	template<typename CharT, typename CharTT>
@@ -37,6 +37,14 @@ export namespace Potato::Format
 		}
 	};
 
+	// Specialize with Value = true to match the pattern section with the table of Reg::StaticDfaBinaryTable,
+	// which is built at compile time but only supports the pattern without counter.
+	template<TMP::TypeString type_string>
+	struct StaticPatternTable
+	{
+		static constexpr bool Value = false;
+	};
+
 	struct DeformatInfo
 	{
 		std::size_t consumed_string = 0;
@@ -120,13 +128,21 @@ export namespace Potato::Format
 		template<TMP::TypeString type_string>
 		struct PatternSectionWrapper
 		{
-			static auto& Wrapper()
+			static auto const& Wrapper()
 			{
-				static const auto buffer = Reg::CreateDfaBinaryTable(
-					Reg::Dfa::FormatE::HeadMatch,
-					type_string.GetStringView()
-				);
-				return buffer;
+				if constexpr (StaticPatternTable<type_string>::Value)
+				{
+					static_assert(Reg::StaticDfaBinaryTable<type_string>::Available, "pattern is out of the subset of StaticDfaBuilder");
+					return Reg::StaticDfaBinaryTable<type_string>::Buffer;
+				}
+				else {
+					static const auto buffer = []() {
+						Reg::Dfa table(Reg::Dfa::FormatE::HeadMatch, type_string.GetStringView());
+						table.BuildUtf8Table();
+						return Reg::CreateDfaBinaryTable(table);
+					}();
+					return buffer;
+				}
 			}
 			template<typename CharT>
 			static std::optional<std::size_t> Execute(std::basic_string_view<CharT> string)
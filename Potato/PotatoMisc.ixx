@@ -321,6 +321,52 @@ export namespace Potato::Misc
 		return OldWriteSize - Mark;
 	}
 
+	// Versioned container of a serialized table. The table only stores offsets relative to its own begin,
+	// so the buffer can be mapped from file and used in place.
+	struct BinaryTableContainer
+	{
+		using StandardT = std::uint32_t;
+
+		static constexpr StandardT MagicNumber = 0x42544F50;
+		static constexpr StandardT EndianMark = 0x01020304;
+
+		struct HeadT
+		{
+			StandardT Magic = MagicNumber;
+			StandardT Endian = EndianMark;
+			StandardT Tag = 0;
+			StandardT Version = 0;
+			StandardT TableOffset = 0;
+			StandardT TableSize = 0;
+			StandardT Checksum = 0;
+			StandardT Reserved = 0;
+		};
+
+		enum class CheckResultE
+		{
+			Ok,
+			BadSize,
+			BadMagic,
+			BadEndian,
+			BadTag,
+			BadVersion,
+			BadChecksum,
+		};
+
+		static std::vector<StandardT> Create(StandardT Tag, StandardT Version, std::span<StandardT const> Table);
+
+		// Only the head is checked unless VerifyChecksum is set, which reads the whole table.
+		static CheckResultE Check(std::span<StandardT const> Buffer, StandardT Tag, StandardT Version, bool VerifyChecksum = false);
+
+		// Return the table of a buffer which has passed the Check.
+		static std::span<StandardT const> GetTable(std::span<StandardT const> Buffer);
+
+		// Return an empty span if the memory is not aligned to StandardT.
+		static std::span<StandardT const> Reinterpret(std::span<std::byte const> Memory);
+
+		static StandardT Checksum(std::span<StandardT const> Table);
+	};
+
 	struct LineRecorder
 	{
 		std::size_t Line = 0;
@@ -340,6 +386,65 @@ export namespace Potato::Misc
 		return re;
 	}
 
+	// Call Function(Index) for Index in [0, Count) over ThreadCount threads, ThreadCount 0 means std::thread::hardware_concurrency.
+	// Each thread takes at least TaskPerThread tasks, a small Count is not worth waking up the threads.
+	// Function may also take a WorkerStateT& which is created once per thread.
+	// The exception of the smallest index is rethrown, so a failure is the same as the one of a serial loop.
+	template<typename WorkerStateT = std::monostate, typename FunctionT>
+	void ParallelFor(std::size_t Count, std::size_t ThreadCount, std::size_t TaskPerThread, FunctionT&& Function)
+	{
+		auto Call = [&](std::size_t Index, WorkerStateT& State) {
+			if constexpr (std::is_invocable_v<FunctionT&, std::size_t, WorkerStateT&>)
+				Function(Index, State);
+			else
+				Function(Index);
+		};
+
+		if (ThreadCount == 0)
+			ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+		std::size_t WorkerCount = std::min(ThreadCount, (Count + TaskPerThread - 1) / std::max(TaskPerThread, std::size_t(1)));
+
+		if (WorkerCount <= 1)
+		{
+			WorkerStateT State{};
+			for (std::size_t Index = 0; Index < Count; ++Index)
+				Call(Index, State);
+			return;
+		}
+
+		std::vector<std::exception_ptr> Exceptions(Count);
+		std::atomic_size_t NextIndex = 0;
+
+		auto Worker = [&]()
+		{
+			WorkerStateT State{};
+			for (std::size_t Index = NextIndex++; Index < Count; Index = NextIndex++)
+			{
+				try {
+					Call(Index, State);
+				}
+				catch (...)
+				{
+					Exceptions[Index] = std::current_exception();
+				}
+			}
+		};
+
+		{
+			std::vector<std::jthread> Threads;
+			for (std::size_t I = 1; I < WorkerCount; ++I)
+				Threads.emplace_back(Worker);
+			Worker();
+		}
+
+		for (auto& Ite : Exceptions)
+		{
+			if (Ite)
+				std::rethrow_exception(Ite);
+		}
+	}
+
 }
 
 module:private;
@@ -380,5 +485,66 @@ namespace Potato::Misc
 		std::size_t Except = 0;
 		return ref.compare_exchange_strong(Except, 1, std::memory_order_relaxed, std::memory_order_relaxed);
 	}
+
+	std::vector<BinaryTableContainer::StandardT> BinaryTableContainer::Create(StandardT Tag, StandardT Version, std::span<StandardT const> Table)
+	{
+		HeadT Head;
+		Head.Tag = Tag;
+		Head.Version = Version;
+		Head.TableOffset = static_cast<StandardT>(AlignedSize<StandardT>(sizeof(HeadT)));
+		CrossTypeSetThrow<std::length_error>(Head.TableSize, Table.size(), "BinaryTableContainer : table too large");
+		Head.Checksum = Checksum(Table);
+
+		std::vector<StandardT> Buffer;
+		Buffer.resize(Head.TableOffset + Table.size());
+		std::memcpy(Buffer.data(), &Head, sizeof(HeadT));
+		std::copy(Table.begin(), Table.end(), Buffer.begin() + Head.TableOffset);
+		return Buffer;
+	}
+
+	auto BinaryTableContainer::Check(std::span<StandardT const> Buffer, StandardT Tag, StandardT Version, bool VerifyChecksum) -> CheckResultE
+	{
+		if (Buffer.size() < AlignedSize<StandardT>(sizeof(HeadT)))
+			return CheckResultE::BadSize;
+		auto Head = reinterpret_cast<HeadT const*>(Buffer.data());
+		if (Head->Magic != MagicNumber)
+			return CheckResultE::BadMagic;
+		if (Head->Endian != EndianMark)
+			return CheckResultE::BadEndian;
+		if (Head->Tag != Tag)
+			return CheckResultE::BadTag;
+		if (Head->Version != Version)
+			return CheckResultE::BadVersion;
+		if (Head->TableOffset < AlignedSize<StandardT>(sizeof(HeadT)) || Head->TableOffset > Buffer.size() || Buffer.size() - Head->TableOffset < Head->TableSize)
+			return CheckResultE::BadSize;
+		if (VerifyChecksum && Checksum(Buffer.subspan(Head->TableOffset, Head->TableSize)) != Head->Checksum)
+			return CheckResultE::BadChecksum;
+		return CheckResultE::Ok;
+	}
+
+	auto BinaryTableContainer::GetTable(std::span<StandardT const> Buffer) -> std::span<StandardT const>
+	{
+		auto Head = reinterpret_cast<HeadT const*>(Buffer.data());
+		return Buffer.subspan(Head->TableOffset, Head->TableSize);
+	}
+
+	auto BinaryTableContainer::Reinterpret(std::span<std::byte const> Memory) -> std::span<StandardT const>
+	{
+		if (reinterpret_cast<std::uintptr_t>(Memory.data()) % alignof(StandardT) != 0)
+			return {};
+		return std::span(reinterpret_cast<StandardT const*>(Memory.data()), Memory.size() / sizeof(StandardT));
+	}
+
+	auto BinaryTableContainer::Checksum(std::span<StandardT const> Table) -> StandardT
+	{
+		// FNV-1a over the words
+		StandardT Result = 2166136261u;
+		for (auto Ite : Table)
+		{
+			Result ^= Ite;
+			Result *= 16777619u;
+		}
+		return Result;
+	}
 }
 
@@ -2,6 +2,14 @@ module;
 
 #include <cassert>
 
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <immintrin.h>
+#define POTATO_REG_SIMD_SSE2
+#if defined(__AVX2__)
+#define POTATO_REG_SIMD_AVX2
+#endif
+#endif
+
 module PotatoReg;
 import PotatoTMP;
 
@@ -988,6 +996,7 @@ namespace Potato::Reg
 	void Nfa::Link(Nfa const& Input)
 	{
 		assert(Input.Nodes.size() >= 1);
+		assert(!Unanchored && !Input.Unanchored);
 		Nodes.reserve(Nodes.size() + Input.Nodes.size() - 1);
 		auto Last = Nodes.size();
 		Nodes.insert(Nodes.end(), Input.Nodes.begin() + 1, Input.Nodes.end());
@@ -1022,6 +1031,72 @@ namespace Potato::Reg
 		MaskIndex += Input.MaskIndex;
 	}
 
+	void Nfa::MakeUnanchored()
+	{
+		assert(!Unanchored && !Nodes.empty());
+
+		for (auto& Ite : Nodes)
+		{
+			Ite.CurIndex += 1;
+			for (auto& Ite2 : Ite.Edges)
+			{
+				Ite2.ToNode += 1;
+				for (auto Ite3 = Ite2.Propertys.begin(); Ite3 != Ite2.Propertys.end(); ++Ite3)
+				{
+					if (Ite3->Type == EdgePropertyE::CaptureBegin || Ite3->Type == EdgePropertyE::CaptureEnd)
+						Ite3->Index += 1;
+					else if (Ite3->Type == EdgePropertyE::RecordAcceptLocation)
+					{
+						Ite3 = Ite2.Propertys.insert(Ite3, { EdgePropertyE::CaptureEnd, 0, 0 });
+						++Ite3;
+					}
+				}
+			}
+		}
+
+		NodeT Startup;
+		Startup.CurIndex = 0;
+		Startup.Edges = Nodes[0].Edges;
+		for (auto& Ite : Startup.Edges)
+			Ite.Propertys.insert(Ite.Propertys.begin(), { EdgePropertyE::CaptureBegin, 0, 0 });
+
+		// last edge with the lowest priority, so it is lazy
+		EdgeT Loop;
+		Loop.ToNode = 0;
+		Loop.CharSets = MaxInterval();
+		Loop.MaskIndex = MaskIndex;
+		Startup.Edges.push_back(std::move(Loop));
+
+		Nodes.insert(Nodes.begin(), std::move(Startup));
+		Unanchored = true;
+	}
+
+	void Nfa::RemoveCapture(bool KeepImplicitCapture)
+	{
+		std::size_t KeepCount = (Unanchored && KeepImplicitCapture) ? 1 : 0;
+		for (auto& Ite : Nodes)
+		{
+			for (auto& Ite2 : Ite.Edges)
+			{
+				std::erase_if(Ite2.Propertys, [=](PropertyT const& Pro) {
+					return (Pro.Type == EdgePropertyE::CaptureBegin || Pro.Type == EdgePropertyE::CaptureEnd) && Pro.Index >= KeepCount;
+				});
+			}
+
+			// edges only different in capture are the same now, keep the first one.
+			for (std::size_t I = 0; I < Ite.Edges.size(); ++I)
+			{
+				for (std::size_t I2 = I + 1; I2 < Ite.Edges.size();)
+				{
+					if (Ite.Edges[I] == Ite.Edges[I2] && Ite.Edges[I].MaskIndex == Ite.Edges[I2].MaskIndex)
+						Ite.Edges.erase(Ite.Edges.begin() + I2);
+					else
+						++I2;
+				}
+			}
+		}
+	}
+
 
 	void MartixStateT::ResetRowCount(std::size_t RowCount)
 	{
@@ -1143,9 +1218,13 @@ namespace Potato::Reg
 		}
 	};
 
-	Dfa::Dfa(FormatE Format, Nfa const& T1)
-		: Format(Format)
+	Dfa::Dfa(FormatE Format, Nfa const& T1, std::size_t ThreadCount, std::size_t MaxStateCount, bool Minimized)
+		: Format(Format), Unanchored(T1.Unanchored)
 	{
+		constexpr std::size_t ParallelStatePerThread = 8;
+
+		if (ThreadCount == 0)
+			ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
 
 		std::map<NfaEdgeKeyT, NfaEdgePropertyT> EdgeMapping;
 
@@ -1217,40 +1296,16 @@ namespace Potato::Reg
 
 		std::map<std::vector<std::size_t>, std::size_t> Mapping;
 
-		std::vector<decltype(Mapping)::const_iterator> SearchingStack;
-
 		std::vector<TempNodeT> TempNode;
 
-		{
-			std::vector<std::size_t> StartupNode = {0};
-			auto [Ite, B] = Mapping.insert({ StartupNode, TempNode.size() });
-
-			TempNodeT Startup;
-
-			for (auto Ite : StartupNode)
-			{
-				Startup.Accept = T1.Nodes[Ite].Accept;
-				if (Startup.Accept.has_value())
-					break;
-			}
-
-			Startup.OriginalToNode = std::move(StartupNode);
-			
-			TempNode.push_back(std::move(Startup));
-			SearchingStack.push_back(Ite);
-		}
-
-		std::vector<TempEdgeT> TempEdges;
-
-		MartixStateT MartixState;
-
-		while (!SearchingStack.empty())
+		// Expand one state, the ToNode of the edges are the index of Targets until they are interned by ResolveTargets.
+		// Only read the shared data, so the states of the same frontier can be expanded in parallel.
+		auto ExpandState = [&](std::vector<std::size_t> const& OriginalToNode, std::vector<TempEdgeT>& TempEdges, std::vector<std::vector<std::size_t>>& Targets, MartixStateT& MartixState)
 		{
 			TempEdges.clear();
-			auto Top = *SearchingStack.rbegin();
-			SearchingStack.pop_back();
+			Targets.clear();
 
-			for (auto Ite : Top->first)
+			for (auto Ite : OriginalToNode)
 			{
 				auto& EdgeRef = T1.Nodes[Ite].Edges;
 				std::size_t EdgeIndex = 0;
@@ -1338,7 +1393,7 @@ namespace Potato::Reg
 
 			if (Format == FormatE::HeadMatch || Format == FormatE::GreedyHeadMatch)
 			{
-				for (auto Ite : Top->first)
+				for (auto Ite : OriginalToNode)
 				{
 					if (T1.Nodes[Ite].Accept.has_value())
 					{
@@ -1389,6 +1444,40 @@ namespace Potato::Reg
 					}
 				}
 
+				if (T1.Unanchored)
+				{
+					// once a match is found, stop starting new match
+					for (std::size_t I = 0; I < Ite.Propertys.size(); ++I)
+					{
+						auto& EdgePro = Ite.Propertys[I].Key->second;
+						if (EdgePro.Ranges.empty() && EdgePro.ToAccept)
+						{
+							Ite.Propertys.erase(
+								std::remove_if(Ite.Propertys.begin() + I + 1, Ite.Propertys.end(), [&](TempPropertyT const& T) {
+									return T.Key->first.From == 0 || T.Key->second.MaskIndex == T1.MaskIndex;
+								}),
+								Ite.Propertys.end()
+							);
+							break;
+						}
+					}
+
+					// leftmost first, the node reached by an earlier thread ignores the later one
+					for (std::size_t I = 0; I < Ite.Propertys.size(); ++I)
+					{
+						auto& EdgePro = Ite.Propertys[I].Key->second;
+						if (!EdgePro.Ranges.empty())
+							continue;
+						auto ToNode = EdgePro.ToNode;
+						Ite.Propertys.erase(
+							std::remove_if(Ite.Propertys.begin() + I + 1, Ite.Propertys.end(), [=](TempPropertyT const& T) {
+								return T.Key->second.ToNode == ToNode;
+							}),
+							Ite.Propertys.end()
+						);
+					}
+				}
+
 				assert(!Ite.Propertys.empty());
 
 				MartixState.ResetRowCount(Ite.Propertys.size());
@@ -1572,21 +1661,7 @@ namespace Potato::Reg
 							CacheNode.push_back(*HasAcceptNode);
 					}
 
-					auto [MapIte, Bool] = Mapping.insert({ CacheNode, TempNode.size() });
-
-					if (Bool)
-					{
-						TempNodeT TemNode;
-						for (auto Ite3 : CacheNode)
-						{
-							TemNode.Accept = T1.Nodes[Ite3].Accept;
-							if (TemNode.Accept.has_value())
-								break;
-						}
-						TemNode.OriginalToNode = CacheNode;
-						TempNode.push_back(std::move(TemNode));
-						SearchingStack.push_back(MapIte);
-					}
+					Targets.push_back(CacheNode);
 
 					auto Re = MartixState.ReadLine(Line);
 
@@ -1608,14 +1683,82 @@ namespace Potato::Reg
 						}
 					}
 
-					NewToNode.ToNode = MapIte->second;
+					NewToNode.ToNode = Targets.size() - 1;
 
 					Ite.ToNode.push_back(std::move(NewToNode));
 				}
 
 			}
+		};
+
+		auto InternState = [&](std::vector<std::size_t> const& CacheNode) -> std::tuple<std::size_t, bool>
+		{
+			auto [MapIte, Bool] = Mapping.insert({ CacheNode, TempNode.size() });
+
+			if (Bool)
+			{
+				if (TempNode.size() >= MaxStateCount)
+					throw RegexOutOfRange{ RegexOutOfRange::TypeT::StateCount, TempNode.size() };
+				TempNodeT TemNode;
+				for (auto Ite3 : CacheNode)
+				{
+					TemNode.Accept = T1.Nodes[Ite3].Accept;
+					if (TemNode.Accept.has_value())
+						break;
+				}
+				TemNode.OriginalToNode = CacheNode;
+				TempNode.push_back(std::move(TemNode));
+			}
+
+			return { MapIte->second, Bool };
+		};
+
+		auto ResolveTargets = [&](std::vector<TempEdgeT>& TempEdges, std::vector<std::vector<std::size_t>> const& Targets, std::vector<std::size_t>& NewStates)
+		{
+			for (auto& Ite : TempEdges)
+			{
+				for (auto& Ite2 : Ite.ToNode)
+				{
+					auto [Index, IsNew] = InternState(Targets[Ite2.ToNode]);
+					if (IsNew)
+						NewStates.push_back(Index);
+					Ite2.ToNode = Index;
+				}
+			}
+		};
+
+		InternState({ 0 });
+
+		// breadth first for every thread count, the states are interned in the order of the frontier,
+		// so the result does not depend on the scheduling or the thread count, ParallelFor runs inline for one thread
+		struct ExpandResultT
+		{
+			std::vector<TempEdgeT> TempEdges;
+			std::vector<std::vector<std::size_t>> Targets;
+		};
+
+		std::vector<std::size_t> Frontier = { 0 };
+		std::vector<std::size_t> NextFrontier;
+		std::vector<ExpandResultT> Results;
 
-			TempNode[Top->second].TempEdge = TempEdges;
+		while (!Frontier.empty())
+		{
+			Results.clear();
+			Results.resize(Frontier.size());
+
+			Misc::ParallelFor<MartixStateT>(Frontier.size(), ThreadCount, ParallelStatePerThread, [&](std::size_t Index, MartixStateT& MartixState) {
+				auto& Result = Results[Index];
+				ExpandState(TempNode[Frontier[Index]].OriginalToNode, Result.TempEdges, Result.Targets, MartixState);
+			});
+
+			NextFrontier.clear();
+			for (std::size_t I = 0; I < Frontier.size(); ++I)
+			{
+				auto& Result = Results[I];
+				ResolveTargets(Result.TempEdges, Result.Targets, NextFrontier);
+				TempNode[Frontier[I]].TempEdge = std::move(Result.TempEdges);
+			}
+			std::swap(Frontier, NextFrontier);
 		}
 
 		struct ActionIndexMappingNodeT
@@ -2187,6 +2330,342 @@ namespace Potato::Reg
 			}
 		}
 
+		if (Minimized)
+			Minimize();
+		BuildPrefilter();
+		CaptureFree = DetectCaptureFree();
+	}
+
+	bool Dfa::DetectCaptureFree() const
+	{
+		for (auto& Ite : Nodes)
+		{
+			for (auto& Ite2 : Ite.Edges)
+			{
+				if (Ite2.Conditions.size() != 1)
+					return false;
+				auto Command = Ite2.Conditions[0].PassCommand;
+				if (Command != ConditionT::CommandE::ToNode && Command != ConditionT::CommandE::ToAcceptNode)
+					return false;
+				if (Ite2.Propertys.size() > 1 || (Ite2.Propertys.size() == 1 && Ite2.Propertys[0].Action != PropertyActioE::RecordAcceptLocation))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	void Dfa::Minimize()
+	{
+		auto IsJump = [](ConditionT::CommandE Command) {
+			return Command == ConditionT::CommandE::ToNode || Command == ConditionT::CommandE::ToAcceptNode;
+		};
+
+		std::vector<std::size_t> Block;
+		Block.resize(Nodes.size(), 0);
+		std::size_t BlockCount = 1;
+
+		std::map<std::vector<std::size_t>, std::size_t> Mapping;
+		std::vector<std::size_t> Signature;
+		std::vector<std::size_t> NewBlock;
+		NewBlock.resize(Nodes.size());
+
+		// nodes stay in the same block only when they have the same accept and the same edges leading to the same blocks
+		while (true)
+		{
+			Mapping.clear();
+
+			for (std::size_t I = 0; I < Nodes.size(); ++I)
+			{
+				auto& NodeRef = Nodes[I];
+				Signature.clear();
+				Signature.push_back(Block[I]);
+				if (NodeRef.Accept.has_value())
+				{
+					Signature.push_back(1);
+					Signature.push_back(NodeRef.Accept->Mask);
+					Signature.push_back(NodeRef.Accept->CaptureIndex.Begin());
+					Signature.push_back(NodeRef.Accept->CaptureIndex.End());
+				}
+				else
+					Signature.push_back(0);
+
+				Signature.push_back(NodeRef.Edges.size());
+				for (auto& Ite : NodeRef.Edges)
+				{
+					Signature.push_back(Ite.CharSets.Size());
+					for (auto& Ite2 : Ite.CharSets)
+					{
+						Signature.push_back(Ite2.Start);
+						Signature.push_back(Ite2.End);
+					}
+					Signature.push_back(Ite.Propertys.size());
+					for (auto& Ite2 : Ite.Propertys)
+					{
+						Signature.push_back(static_cast<std::size_t>(Ite2.Action));
+						Signature.push_back(Ite2.Solt);
+						Signature.push_back(Ite2.Par);
+					}
+					Signature.push_back(Ite.Conditions.size());
+					for (auto& Ite2 : Ite.Conditions)
+					{
+						Signature.push_back(static_cast<std::size_t>(Ite2.PassCommand));
+						Signature.push_back(IsJump(Ite2.PassCommand) ? Block[Ite2.Pass] : Ite2.Pass);
+						Signature.push_back(static_cast<std::size_t>(Ite2.UnpassCommand));
+						Signature.push_back(IsJump(Ite2.UnpassCommand) ? Block[Ite2.Unpass] : Ite2.Unpass);
+					}
+				}
+
+				auto [Ite, B] = Mapping.insert({ Signature, Mapping.size() });
+				NewBlock[I] = Ite->second;
+			}
+
+			std::swap(Block, NewBlock);
+
+			if (Mapping.size() == BlockCount)
+				break;
+			BlockCount = Mapping.size();
+		}
+
+		if (BlockCount == Nodes.size())
+			return;
+
+		// block index follows the first node of the block, so the startup node is still 0
+		std::vector<NodeT> NewNodes;
+		NewNodes.reserve(BlockCount);
+		for (std::size_t I = 0; I < Nodes.size(); ++I)
+		{
+			if (Block[I] == NewNodes.size())
+			{
+				auto NewNode = std::move(Nodes[I]);
+				for (auto& Ite : NewNode.Edges)
+				{
+					for (auto& Ite2 : Ite.Conditions)
+					{
+						if (IsJump(Ite2.PassCommand))
+							Ite2.Pass = Block[Ite2.Pass];
+						if (IsJump(Ite2.UnpassCommand))
+							Ite2.Unpass = Block[Ite2.Unpass];
+					}
+				}
+				NewNodes.push_back(std::move(NewNode));
+			}
+		}
+
+		Nodes = std::move(NewNodes);
+
+		if (HasClassTable())
+		{
+			BuildClassTable();
+			if (HasUtf8Table())
+				Utf8.Build(Classes);
+		}
+	}
+
+	void Dfa::BuildPrefilter()
+	{
+		PrefilterPrefix.clear();
+		PrefilterStartByte.fill(0);
+
+		Prefilter Filter;
+
+		auto& StartNode = Nodes[GetStartupNodeIndex()];
+
+		for (auto& Ite : StartNode.Edges)
+		{
+			for (auto& Ite2 : Ite.Conditions)
+			{
+				// the match may be empty, every position is a candidate
+				if (Ite2.PassCommand == ConditionT::CommandE::ToAcceptNode || Ite2.UnpassCommand == ConditionT::CommandE::ToAcceptNode)
+				{
+					PrefilterStartByte.fill(std::numeric_limits<std::uint32_t>::max());
+					return;
+				}
+			}
+
+			for (auto& Ite2 : Ite.CharSets)
+			{
+				auto LeadByte = [](CodePointT Input) -> char8_t {
+					if (Input < 0x80)
+						return static_cast<char8_t>(Input);
+					else if (Input < 0x800)
+						return static_cast<char8_t>(0xC0 | (Input >> 6));
+					else if (Input < 0x10000)
+						return static_cast<char8_t>(0xE0 | (Input >> 12));
+					else
+						return static_cast<char8_t>(0xF0 | (Input >> 18));
+				};
+				auto End = std::min(Ite2.End, MaxChar());
+				if (Ite2.Start >= End)
+					continue;
+				for (std::size_t Byte = LeadByte(Ite2.Start); Byte <= LeadByte(End - 1); ++Byte)
+					Filter.MarkStartByte(static_cast<char8_t>(Byte));
+			}
+		}
+
+		PrefilterStartByte = Filter.StartByte;
+
+		std::vector<bool> Visited(Nodes.size(), false);
+		std::size_t CurNode = GetStartupNodeIndex();
+		while (true)
+		{
+			Visited[CurNode] = true;
+			auto& NodeRef = Nodes[CurNode];
+			if (NodeRef.Edges.size() != 1)
+				break;
+			auto& Edge = NodeRef.Edges[0];
+			if (Edge.CharSets.Size() != 1)
+				break;
+			auto Char = Edge.CharSets[0];
+			if (Char.Start + 1 != Char.End || Char.Start == EndOfFile())
+				break;
+
+			std::optional<std::size_t> ToNode;
+			bool Unique = true;
+			bool ToAccept = false;
+			for (auto& Ite : Edge.Conditions)
+			{
+				for (auto [Command, Target] : { std::tuple{Ite.PassCommand, Ite.Pass}, std::tuple{Ite.UnpassCommand, Ite.Unpass} })
+				{
+					if (Command == ConditionT::CommandE::ToAcceptNode)
+						ToAccept = true;
+					else if (Command == ConditionT::CommandE::ToNode)
+					{
+						if (ToNode.has_value() && *ToNode != Target)
+							Unique = false;
+						ToNode = Target;
+					}
+				}
+			}
+
+			if (ToAccept)
+				break;
+
+			std::array<char8_t, 4> Temp;
+			auto Info = Encode::UnicodeEncoder<CodePointT, char8_t>::EncodeTo(std::span(&Char.Start, 1), std::span(Temp));
+			PrefilterPrefix.append(Temp.data(), Info.target_space);
+
+			if (!Unique || !ToNode.has_value() || Visited[*ToNode])
+				break;
+			CurNode = *ToNode;
+		}
+	}
+
+	std::size_t Prefilter::GetStartByteCount() const
+	{
+		std::size_t Count = 0;
+		for (auto Ite : StartByte)
+			Count += std::popcount(Ite);
+		return Count;
+	}
+
+	struct PrefilterScanner
+	{
+#if defined(POTATO_REG_SIMD_AVX2)
+		using BlockT = __m256i;
+		static constexpr std::size_t BlockSize = 32;
+		static BlockT Load(char8_t const* Adress) { return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(Adress)); }
+		static BlockT Set(char8_t Byte) { return _mm256_set1_epi8(static_cast<char>(Byte)); }
+		static BlockT Equal(BlockT I1, BlockT I2) { return _mm256_cmpeq_epi8(I1, I2); }
+		static BlockT Or(BlockT I1, BlockT I2) { return _mm256_or_si256(I1, I2); }
+		static BlockT And(BlockT I1, BlockT I2) { return _mm256_and_si256(I1, I2); }
+		static std::uint32_t Mask(BlockT I1) { return static_cast<std::uint32_t>(_mm256_movemask_epi8(I1)); }
+#elif defined(POTATO_REG_SIMD_SSE2)
+		using BlockT = __m128i;
+		static constexpr std::size_t BlockSize = 16;
+		static BlockT Load(char8_t const* Adress) { return _mm_loadu_si128(reinterpret_cast<__m128i const*>(Adress)); }
+		static BlockT Set(char8_t Byte) { return _mm_set1_epi8(static_cast<char>(Byte)); }
+		static BlockT Equal(BlockT I1, BlockT I2) { return _mm_cmpeq_epi8(I1, I2); }
+		static BlockT Or(BlockT I1, BlockT I2) { return _mm_or_si128(I1, I2); }
+		static BlockT And(BlockT I1, BlockT I2) { return _mm_and_si128(I1, I2); }
+		static std::uint32_t Mask(BlockT I1) { return static_cast<std::uint32_t>(_mm_movemask_epi8(I1)); }
+#endif
+
+		// memchr like, up to 3 different bytes
+		static std::optional<std::size_t> FindBytes(std::span<char8_t const> Str, std::size_t Offset, std::span<char8_t const> Bytes)
+		{
+			assert(!Bytes.empty() && Bytes.size() <= 3);
+#if defined(POTATO_REG_SIMD_SSE2)
+			auto B0 = Set(Bytes[0]);
+			auto B1 = Set(Bytes.size() > 1 ? Bytes[1] : Bytes[0]);
+			auto B2 = Set(Bytes.size() > 2 ? Bytes[2] : Bytes[0]);
+			for (; Offset + BlockSize <= Str.size(); Offset += BlockSize)
+			{
+				auto Block = Load(Str.data() + Offset);
+				auto Re = Mask(Or(Or(Equal(Block, B0), Equal(Block, B1)), Equal(Block, B2)));
+				if (Re != 0)
+					return Offset + std::countr_zero(Re);
+			}
+#endif
+			for (; Offset < Str.size(); ++Offset)
+			{
+				if (std::find(Bytes.begin(), Bytes.end(), Str[Offset]) != Bytes.end())
+					return Offset;
+			}
+			return std::nullopt;
+		}
+
+		// memmem like, filter by the first and the last byte of the prefix then compare
+		static std::optional<std::size_t> FindPrefix(std::span<char8_t const> Str, std::size_t Offset, std::u8string_view Prefix)
+		{
+			assert(Prefix.size() >= 2);
+			auto Last = Prefix.size() - 1;
+#if defined(POTATO_REG_SIMD_SSE2)
+			auto First = Set(Prefix[0]);
+			auto End = Set(Prefix[Last]);
+			for (; Offset + Last + BlockSize <= Str.size(); Offset += BlockSize)
+			{
+				auto Re = Mask(And(Equal(Load(Str.data() + Offset), First), Equal(Load(Str.data() + Offset + Last), End)));
+				while (Re != 0)
+				{
+					auto Index = Offset + std::countr_zero(Re);
+					if (std::equal(Prefix.begin() + 1, Prefix.end() - 1, Str.begin() + Index + 1))
+						return Index;
+					Re &= Re - 1;
+				}
+			}
+#endif
+			for (; Offset + Prefix.size() <= Str.size(); ++Offset)
+			{
+				if (std::equal(Prefix.begin(), Prefix.end(), Str.begin() + Offset))
+					return Offset;
+			}
+			return std::nullopt;
+		}
+	};
+
+	std::optional<std::size_t> Prefilter::Find(std::span<char8_t const> Str, std::size_t Offset) const
+	{
+		if (Offset > Str.size())
+			return std::nullopt;
+
+		if (Prefix.size() >= 2)
+			return PrefilterScanner::FindPrefix(Str, Offset, Prefix);
+
+		std::size_t Count = GetStartByteCount();
+
+		if (Count == StartByteCount)
+			return Offset;
+
+		if (Count <= 3)
+		{
+			if (Count == 0)
+				return std::nullopt;
+			std::array<char8_t, 3> Bytes;
+			std::size_t Index = 0;
+			for (std::size_t Byte = 0; Byte < StartByteCount; ++Byte)
+			{
+				if (IsStartByte(static_cast<char8_t>(Byte)))
+					Bytes[Index++] = static_cast<char8_t>(Byte);
+			}
+			return PrefilterScanner::FindBytes(Str, Offset, std::span(Bytes).subspan(0, Count));
+		}
+
+		for (; Offset < Str.size(); ++Offset)
+		{
+			if (IsStartByte(Str[Offset]))
+				return Offset;
+		}
+		return std::nullopt;
 	}
 
 	void DfaProcessor::Clear()
@@ -2195,6 +2674,8 @@ namespace Potato::Reg
 		CacheIndex.clear();
 		TempResult.clear();
 		Record.Clear();
+		Utf8State = 0;
+		Utf8CharStart = 0;
 		if (std::holds_alternative<std::reference_wrapper<Dfa const>>(TableWrapper))
 		{
 			auto& Ref = std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get();
@@ -2202,6 +2683,14 @@ namespace Potato::Reg
 			CacheIndex.resize(Ref.GetCacheCounterCount(), 0);
 			TempResult.reserve(Ref.GetTempResultCount());
 		}
+		else if (std::holds_alternative<std::reference_wrapper<LazyDfa>>(TableWrapper))
+		{
+			CurNodeIndex = std::get<std::reference_wrapper<LazyDfa>>(TableWrapper).get().GetStartupNodeIndex();
+		}
+		else if (std::holds_alternative<std::reference_wrapper<BitParallelNfa const>>(TableWrapper))
+		{
+			PositionState = std::get<std::reference_wrapper<BitParallelNfa const>>(TableWrapper).get().GetStartupState();
+		}
 		else {
 			CurNodeIndex = std::get<DfaBinaryTableWrapper>(TableWrapper).GetStartupNodeIndex();
 			CacheIndex.resize(std::get<DfaBinaryTableWrapper>(TableWrapper).GetCacheCounterCount(), 0);
@@ -2216,6 +2705,14 @@ namespace Potato::Reg
 		{
 			return std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().Consume(*this, Token, TokenIndex);
 		}
+		else if (std::holds_alternative<std::reference_wrapper<LazyDfa>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<LazyDfa>>(TableWrapper).get().Consume(*this, Token, TokenIndex);
+		}
+		else if (std::holds_alternative<std::reference_wrapper<BitParallelNfa const>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<BitParallelNfa const>>(TableWrapper).get().Consume(*this, Token, TokenIndex);
+		}
 		else {
 			return std::get<DfaBinaryTableWrapper>(TableWrapper).Consume(*this, Token, TokenIndex);
 		}
@@ -2227,6 +2724,14 @@ namespace Potato::Reg
 		{
 			return std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().HasAccept(*this);
 		}
+		else if (std::holds_alternative<std::reference_wrapper<LazyDfa>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<LazyDfa>>(TableWrapper).get().HasAccept(*this);
+		}
+		else if (std::holds_alternative<std::reference_wrapper<BitParallelNfa const>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<BitParallelNfa const>>(TableWrapper).get().HasAccept(*this);
+		}
 		else {
 			return std::get<DfaBinaryTableWrapper>(TableWrapper).HasAccept(*this);
 		}
@@ -2239,6 +2744,14 @@ namespace Potato::Reg
 		{
 			return std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().GetAccept(*this);
 		}
+		else if (std::holds_alternative<std::reference_wrapper<LazyDfa>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<LazyDfa>>(TableWrapper).get().GetAccept(*this);
+		}
+		else if (std::holds_alternative<std::reference_wrapper<BitParallelNfa const>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<BitParallelNfa const>>(TableWrapper).get().GetAccept(*this);
+		}
 		else {
 			return std::get<DfaBinaryTableWrapper>(TableWrapper).GetAccept(*this);
 		}
@@ -2256,136 +2769,485 @@ namespace Potato::Reg
 		return true;
 	}
 
-	bool Dfa::Consume(DfaProcessor& Context, CodePointT Token, std::size_t TokenIndex) const
+	Prefilter DfaProcessor::GetPrefilter() const
 	{
-		auto& NodeRef = Nodes[Context.CurNodeIndex];
-		for (auto& Ite : NodeRef.Edges)
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		if (std::holds_alternative<std::reference_wrapper<Dfa const>>(TableWrapper))
 		{
-			if (Ite.CharSets.IsInclude(Token))
-			{
-				Context.TempResult.clear();
-
-				bool DetectReuslt = true;
-				for (auto& Ite2 : Ite.Propertys)
-				{
-					if (DetectReuslt)
-					{
-						switch (Ite2.Action)
-						{
-						case Dfa::PropertyActioE::CopyValue:
-							Context.CacheIndex[Ite2.Par] = Context.CacheIndex[Ite2.Solt];
-							break;
-						case Dfa::PropertyActioE::RecordLocation:
-							Context.CacheIndex[Ite2.Solt] = TokenIndex;
-							break;
-						case Dfa::PropertyActioE::NewContext:
+			return std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().GetPrefilter();
+		}
+		else if (std::holds_alternative<std::reference_wrapper<LazyDfa>>(TableWrapper) || std::holds_alternative<std::reference_wrapper<BitParallelNfa const>>(TableWrapper))
+		{
+			Prefilter Unavailable;
+			Unavailable.StartByte.fill(std::numeric_limits<std::uint32_t>::max());
+			return Unavailable;
+		}
+		else {
+			return std::get<DfaBinaryTableWrapper>(TableWrapper).GetPrefilter();
+		}
+	}
 
-							break;
-						case Dfa::PropertyActioE::ConstraintsTrueTrue:
-							if (Context.TempResult[Ite2.Solt])
-								DetectReuslt = true;
-							break;
-						case Dfa::PropertyActioE::ConstraintsFalseFalse:
-							if (!Context.TempResult[Ite2.Solt])
-								DetectReuslt = false;
-							break;
-						case Dfa::PropertyActioE::ConstraintsFalseTrue:
-							if (!Context.TempResult[Ite2.Solt])
-								DetectReuslt = true;
-							break;
-						case Dfa::PropertyActioE::ConstraintsTrueFalse:
-							if (Context.TempResult[Ite2.Solt])
-								DetectReuslt = false;
-							break;
-						case Dfa::PropertyActioE::OneCounter:
-							Context.CacheIndex[Ite2.Solt] = 1;
-							break;
-						case Dfa::PropertyActioE::AddCounter:
-							Context.CacheIndex[Ite2.Solt] += 1;
-							break;
-						case Dfa::PropertyActioE::LessCounter:
-							if (Context.CacheIndex[Ite2.Solt] > Ite2.Par)
-								DetectReuslt = false;
-							break;
-						case Dfa::PropertyActioE::BiggerCounter:
-							if (Context.CacheIndex[Ite2.Solt] < Ite2.Par)
-								DetectReuslt = false;
-							break;
-						case Dfa::PropertyActioE::RecordAcceptLocation:
-							Context.Record.Accept(TokenIndex);
-							break;
-						default:
-							assert(false);
-							break;
-						}
-					}
-					if (Ite2.Action == Dfa::PropertyActioE::NewContext)
-					{
-						Context.TempResult.push_back(DetectReuslt ? 1 : 0);
-						DetectReuslt = true;
-					}
-				}
+	bool DfaProcessor::IsUnanchored() const
+	{
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		if (std::holds_alternative<std::reference_wrapper<Dfa const>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().IsUnanchored();
+		}
+		else if (std::holds_alternative<std::reference_wrapper<LazyDfa>>(TableWrapper) || std::holds_alternative<std::reference_wrapper<BitParallelNfa const>>(TableWrapper))
+		{
+			return false;
+		}
+		else {
+			return std::get<DfaBinaryTableWrapper>(TableWrapper).IsUnanchored();
+		}
+	}
 
-				Context.TempResult.push_back(DetectReuslt ? 1 : 0);
+	bool DfaProcessor::IsCaptureFree() const
+	{
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		if (std::holds_alternative<std::reference_wrapper<Dfa const>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().IsCaptureFree();
+		}
+		else if (std::holds_alternative<std::reference_wrapper<LazyDfa>>(TableWrapper) || std::holds_alternative<std::reference_wrapper<BitParallelNfa const>>(TableWrapper))
+		{
+			return true;
+		}
+		else {
+			return std::get<DfaBinaryTableWrapper>(TableWrapper).IsCaptureFree();
+		}
+	}
+
+	bool DfaProcessor::HasUtf8Table() const
+	{
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		if (std::holds_alternative<std::reference_wrapper<Dfa const>>(TableWrapper))
+		{
+			return std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().HasUtf8Table();
+		}
+		else if (std::holds_alternative<std::reference_wrapper<LazyDfa>>(TableWrapper) || std::holds_alternative<std::reference_wrapper<BitParallelNfa const>>(TableWrapper))
+		{
+			return false;
+		}
+		else {
+			return std::get<DfaBinaryTableWrapper>(TableWrapper).HasUtf8Table();
+		}
+	}
+
+	bool DfaProcessor::ConsumeByte(char8_t Byte, std::size_t ByteIndex)
+	{
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		assert(HasUtf8Table());
+		if (Utf8State == 0)
+			Utf8CharStart = ByteIndex;
+		std::size_t Entry = Utf8ClassTable::InvalidEntry;
+		if (std::holds_alternative<std::reference_wrapper<Dfa const>>(TableWrapper))
+		{
+			Entry = std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().GetUtf8Table().Step(Utf8State, Byte);
+		}
+		else {
+			Entry = std::get<DfaBinaryTableWrapper>(TableWrapper).Utf8Step(Utf8State, Byte);
+		}
+		if (Entry == Utf8ClassTable::InvalidEntry)
+		{
+			Utf8State = 0;
+			return false;
+		}
+		else if (Utf8ClassTable::IsClassEntry(Entry))
+		{
+			Utf8State = 0;
+			if (std::holds_alternative<std::reference_wrapper<Dfa const>>(TableWrapper))
+			{
+				return std::get<std::reference_wrapper<Dfa const>>(TableWrapper).get().ConsumeClass(*this, Utf8ClassTable::GetEntryValue(Entry), Utf8CharStart);
+			}
+			else {
+				return std::get<DfaBinaryTableWrapper>(TableWrapper).ConsumeClass(*this, Utf8ClassTable::GetEntryValue(Entry), Utf8CharStart);
+			}
+		}
+		else {
+			Utf8State = Utf8ClassTable::GetEntryValue(Entry);
+			return true;
+		}
+	}
+
+	bool DfaProcessor::FragmentProcess(std::span<char8_t const> input, std::size_t start_byte_index)
+	{
+		for (std::size_t index = 0; index < input.size(); ++index)
+		{
+			if (!ConsumeByte(input[index], start_byte_index + index))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<CodePointT> CharClassTable::Build(std::span<std::vector<Interval const*> const> Groups, std::vector<std::size_t>* GroupHit)
+	{
+		std::vector<CodePointT> Bounds;
+		Bounds.push_back(0);
+		Bounds.push_back(MaxChar());
 
-				std::size_t NextIte = 0;
-				std::optional<std::size_t> ToNode;
-				assert(!Ite.Conditions.empty());
-				bool ToAcceptNode = false;
-				for (auto Ite2 : Context.TempResult)
+		for (auto& Ite : Groups)
+		{
+			for (auto Ite2 : Ite)
+			{
+				for (auto& Ite3 : *Ite2)
 				{
-					assert(!ToNode.has_value());
-					auto& Cond = Ite.Conditions[NextIte];
-					if (Ite2 == 1)
-					{
-						switch (Cond.PassCommand)
-						{
-						case Dfa::ConditionT::CommandE::Next:
-							NextIte = Cond.Pass;
-							break;
-						case Dfa::ConditionT::CommandE::Fail:
-							return false;
-						case Dfa::ConditionT::CommandE::ToNode:
-							ToNode = Cond.Pass;
-							break;
-						case Dfa::ConditionT::CommandE::ToAcceptNode:
-							ToNode = Cond.Pass;
-							ToAcceptNode = true;
-							break;
-						default:
-							assert(false);
-							break;
-						}
-					}
-					else if (Ite2 == 0)
+					Bounds.push_back(Ite3.Start);
+					Bounds.push_back(Ite3.End);
+				}
+			}
+		}
+
+		std::sort(Bounds.begin(), Bounds.end());
+		Bounds.erase(std::unique(Bounds.begin(), Bounds.end()), Bounds.end());
+		Bounds.erase(std::upper_bound(Bounds.begin(), Bounds.end(), MaxChar()), Bounds.end());
+
+		std::size_t SegmentCount = Bounds.size() - 1;
+		std::size_t GroupCount = Groups.size();
+
+		// partition refinement, the segments start in class 0 (no char set in any group), 
+		// every group splits the classes of the segments covered by its char sets by the index of the char set.
+		std::vector<std::size_t> SegmentClass(SegmentCount, 0);
+		std::vector<std::size_t> SegmentHit(SegmentCount, NoEdge);
+		std::vector<std::size_t> SegmentGroup(SegmentCount, GroupCount);
+		std::vector<std::size_t> Touched;
+		std::map<std::tuple<std::size_t, std::size_t>, std::size_t> Split;
+		std::size_t RawClassCount = 1;
+
+		auto ForeachSegment = [&](Interval const& CharSets, auto&& Func) {
+			for (auto& Ite : CharSets)
+			{
+				auto Begin = std::lower_bound(Bounds.begin(), Bounds.end(), Ite.Start);
+				auto End = std::lower_bound(Begin, Bounds.end(), std::min(Ite.End, MaxChar()));
+				for (auto Seg = std::distance(Bounds.begin(), Begin); Seg < std::distance(Bounds.begin(), End); ++Seg)
+					Func(static_cast<std::size_t>(Seg));
+			}
+		};
+
+		for (std::size_t GroupIndex = 0; GroupIndex < GroupCount; ++GroupIndex)
+		{
+			auto& CharSets = Groups[GroupIndex];
+			Touched.clear();
+
+			// char sets may overlap, the first one wins
+			for (std::size_t Index = 0; Index < CharSets.size(); ++Index)
+			{
+				ForeachSegment(*CharSets[Index], [&](std::size_t Seg) {
+					if (SegmentGroup[Seg] != GroupIndex)
 					{
-						switch (Cond.UnpassCommand)
-						{
-						case Dfa::ConditionT::CommandE::Next:
-							NextIte = Cond.Unpass;
-							break;
-						case Dfa::ConditionT::CommandE::Fail:
-							return false;
-						case Dfa::ConditionT::CommandE::ToNode:
-							ToNode = Cond.Unpass;
-							break;
-						default:
-							assert(false);
-							break;
-						}
+						SegmentGroup[Seg] = GroupIndex;
+						SegmentHit[Seg] = Index;
+						Touched.push_back(Seg);
 					}
+				});
+			}
+
+			Split.clear();
+			for (auto Seg : Touched)
+			{
+				auto [Ite, B] = Split.insert({ { SegmentClass[Seg], SegmentHit[Seg] }, RawClassCount });
+				if (B)
+					++RawClassCount;
+				SegmentClass[Seg] = Ite->second;
+			}
+		}
+
+		// renumber by the first segment of each class, class 0 is kept for the code points without any char set
+		std::vector<std::size_t> Renumber(RawClassCount, NoEdge);
+		std::vector<CodePointT> Represent;
+		Renumber[0] = 0;
+		Represent.push_back(0);
+		for (std::size_t Seg = 0; Seg < SegmentCount; ++Seg)
+		{
+			auto& Ite = SegmentClass[Seg];
+			if (Renumber[Ite] == NoEdge)
+			{
+				Renumber[Ite] = Represent.size();
+				Represent.push_back(Bounds[Seg]);
+			}
+			Ite = Renumber[Ite];
+		}
+		ClassCount = Represent.size();
+
+		if (GroupHit != nullptr)
+		{
+			GroupHit->clear();
+			GroupHit->resize(GroupCount * ClassCount, NoEdge);
+			for (std::size_t GroupIndex = 0; GroupIndex < GroupCount; ++GroupIndex)
+			{
+				auto& CharSets = Groups[GroupIndex];
+				for (std::size_t Index = CharSets.size(); Index > 0; --Index)
+				{
+					ForeachSegment(*CharSets[Index - 1], [&](std::size_t Seg) {
+						(*GroupHit)[GroupIndex * ClassCount + SegmentClass[Seg]] = Index - 1;
+					});
 				}
+			}
+		}
+
+		auto SegmentOf = [&](CodePointT Input) -> std::size_t {
+			return std::distance(Bounds.begin(), std::upper_bound(Bounds.begin(), Bounds.end(), Input)) - 1;
+		};
 
-				assert(ToNode.has_value());
+		for (CodePointT Index = 0; Index < DenseCount; ++Index)
+			Dense[Index] = SegmentClass[SegmentOf(Index)];
 
-				Context.CurNodeIndex = *ToNode;
-				Context.Record.RecordConsume(TokenIndex);
-				return !ToAcceptNode;
+		SparseStart.clear();
+		SparseClass.clear();
+
+		auto PushSparse = [&](CodePointT Start, std::size_t Class) {
+			if (SparseClass.empty() || *SparseClass.rbegin() != Class)
+			{
+				SparseStart.push_back(Start);
+				SparseClass.push_back(Class);
+			}
+		};
+
+		PushSparse(DenseCount, SegmentClass[SegmentOf(DenseCount)]);
+		for (std::size_t Seg = SegmentOf(DenseCount) + 1; Seg < SegmentCount; ++Seg)
+			PushSparse(Bounds[Seg], SegmentClass[Seg]);
+		PushSparse(MaxChar(), 0);
+
+		return Represent;
+	}
+
+	void Dfa::BuildClassTable()
+	{
+		// every node is a group, the first edge of the node which includes the code point wins in Consume
+		std::vector<std::vector<Interval const*>> Groups;
+		Groups.resize(Nodes.size());
+		for (std::size_t NodeIndex = 0; NodeIndex < Nodes.size(); ++NodeIndex)
+		{
+			for (auto& Ite : Nodes[NodeIndex].Edges)
+				Groups[NodeIndex].push_back(&Ite.CharSets);
+		}
+		Classes.Build(Groups, &ClassTransition);
+	}
+
+	void Utf8ClassTable::Build(CharClassTable const& Classes)
+	{
+		Continuation.clear();
+		Root.fill(InvalidEntry);
+
+		std::map<std::vector<std::size_t>, std::size_t> StateMapping;
+		std::map<std::tuple<std::size_t, std::size_t>, std::size_t> UniformMapping;
+
+		auto InsertState = [&](std::vector<std::size_t> Row) -> std::size_t {
+			auto [Ite, B] = StateMapping.insert({ std::move(Row), StateMapping.size() + 1 });
+			if (B)
+				Continuation.insert(Continuation.end(), Ite->first.begin(), Ite->first.end());
+			return Ite->second << 1;
+		};
+
+		auto ClassEntry = [&](CodePointT Input) -> std::size_t {
+			return (Classes.Locate(Input) << 1) | 1;
+		};
+
+		// all code points under this state belong to the same class
+		auto UniformState = [&](auto& Self, std::size_t Remain, std::size_t Class) -> std::size_t {
+			auto Find = UniformMapping.find({ Remain, Class });
+			if (Find != UniformMapping.end())
+				return Find->second;
+			std::size_t Entry = (Remain == 1) ? ((Class << 1) | 1) : Self(Self, Remain - 1, Class);
+			auto State = InsertState(std::vector<std::size_t>(ContinuationCount, Entry));
+			UniformMapping.insert({ { Remain, Class }, State });
+			return State;
+		};
+
+		auto BuildState = [&](auto& Self, CodePointT Base, std::size_t Remain, CodePointT Min, CodePointT Max) -> std::size_t {
+			std::vector<std::size_t> Row(ContinuationCount, InvalidEntry);
+			CodePointT Step = CodePointT(1) << (6 * (Remain - 1));
+			for (std::size_t I = 0; I < ContinuationCount; ++I)
+			{
+				CodePointT Start = Base + static_cast<CodePointT>(I) * Step;
+				CodePointT End = Start + Step - 1;
+				if (End < Min || Start > Max)
+					continue;
+				if (Remain == 1)
+					Row[I] = ClassEntry(Start);
+				else if (Start >= Min && End <= Max && Classes.IsUniform(Start, End))
+					Row[I] = UniformState(UniformState, Remain - 1, Classes.Locate(Start));
+				else
+					Row[I] = Self(Self, Start, Remain - 1, Min, Max);
 			}
+			return InsertState(std::move(Row));
+		};
+
+		for (std::size_t Byte = 0; Byte < 0x80; ++Byte)
+			Root[Byte] = ClassEntry(static_cast<CodePointT>(Byte));
+		for (std::size_t Byte = 0xC2; Byte < 0xE0; ++Byte)
+			Root[Byte] = BuildState(BuildState, static_cast<CodePointT>(Byte & 0x1F) << 6, 1, 0x80, 0x7FF);
+		for (std::size_t Byte = 0xE0; Byte < 0xF0; ++Byte)
+			Root[Byte] = BuildState(BuildState, static_cast<CodePointT>(Byte & 0x0F) << 12, 2, 0x800, Byte == 0xED ? 0xD7FF : 0xFFFF);
+		for (std::size_t Byte = 0xF0; Byte < 0xF5; ++Byte)
+			Root[Byte] = BuildState(BuildState, static_cast<CodePointT>(Byte & 0x07) << 18, 3, 0x10000, 0x10FFFF);
+
+		StateCount = StateMapping.size() + 1;
+	}
+
+	void Dfa::BuildUtf8Table()
+	{
+		if (!HasClassTable())
+			BuildClassTable();
+		Utf8.Build(Classes);
+	}
+
+	bool Dfa::Consume(DfaProcessor& Context, CodePointT Token, std::size_t TokenIndex) const
+	{
+		auto& NodeRef = Nodes[Context.CurNodeIndex];
+		if (HasClassTable())
+			return ConsumeClass(Context, Classes.Locate(Token), TokenIndex);
+		for (auto& Ite : NodeRef.Edges)
+		{
+			if (Ite.CharSets.IsInclude(Token))
+				return ConsumeEdge(Context, Ite, TokenIndex);
 		}
 		return false;
 	}
 
+	bool Dfa::ConsumeClass(DfaProcessor& Context, std::size_t Class, std::size_t TokenIndex) const
+	{
+		auto EdgeIndex = ClassTransition[Context.CurNodeIndex * Classes.ClassCount + Class];
+		if (EdgeIndex != CharClassTable::NoEdge)
+			return ConsumeEdge(Context, Nodes[Context.CurNodeIndex].Edges[EdgeIndex], TokenIndex);
+		return false;
+	}
+
+	bool Dfa::ConsumeEdge(DfaProcessor& Context, EdgeT const& Edge, std::size_t TokenIndex) const
+	{
+		if (CaptureFree)
+		{
+			if (!Edge.Propertys.empty())
+				Context.Record.Accept(TokenIndex);
+			auto& Cond = Edge.Conditions[0];
+			Context.CurNodeIndex = Cond.Pass;
+			Context.Record.RecordConsume(TokenIndex);
+			return Cond.PassCommand != ConditionT::CommandE::ToAcceptNode;
+		}
+
+		Context.TempResult.clear();
+
+		bool DetectReuslt = true;
+		for (auto& Ite2 : Edge.Propertys)
+		{
+			if (DetectReuslt)
+			{
+				switch (Ite2.Action)
+				{
+				case Dfa::PropertyActioE::CopyValue:
+					Context.CacheIndex[Ite2.Par] = Context.CacheIndex[Ite2.Solt];
+					break;
+				case Dfa::PropertyActioE::RecordLocation:
+					Context.CacheIndex[Ite2.Solt] = TokenIndex;
+					break;
+				case Dfa::PropertyActioE::NewContext:
+
+					break;
+				case Dfa::PropertyActioE::ConstraintsTrueTrue:
+					if (Context.TempResult[Ite2.Solt])
+						DetectReuslt = true;
+					break;
+				case Dfa::PropertyActioE::ConstraintsFalseFalse:
+					if (!Context.TempResult[Ite2.Solt])
+						DetectReuslt = false;
+					break;
+				case Dfa::PropertyActioE::ConstraintsFalseTrue:
+					if (!Context.TempResult[Ite2.Solt])
+						DetectReuslt = true;
+					break;
+				case Dfa::PropertyActioE::ConstraintsTrueFalse:
+					if (Context.TempResult[Ite2.Solt])
+						DetectReuslt = false;
+					break;
+				case Dfa::PropertyActioE::OneCounter:
+					Context.CacheIndex[Ite2.Solt] = 1;
+					break;
+				case Dfa::PropertyActioE::AddCounter:
+					Context.CacheIndex[Ite2.Solt] += 1;
+					break;
+				case Dfa::PropertyActioE::LessCounter:
+					if (Context.CacheIndex[Ite2.Solt] > Ite2.Par)
+						DetectReuslt = false;
+					break;
+				case Dfa::PropertyActioE::BiggerCounter:
+					if (Context.CacheIndex[Ite2.Solt] < Ite2.Par)
+						DetectReuslt = false;
+					break;
+				case Dfa::PropertyActioE::RecordAcceptLocation:
+					Context.Record.Accept(TokenIndex);
+					break;
+				default:
+					assert(false);
+					break;
+				}
+			}
+			if (Ite2.Action == Dfa::PropertyActioE::NewContext)
+			{
+				Context.TempResult.push_back(DetectReuslt ? 1 : 0);
+				DetectReuslt = true;
+			}
+		}
+
+		Context.TempResult.push_back(DetectReuslt ? 1 : 0);
+
+		std::size_t NextIte = 0;
+		std::optional<std::size_t> ToNode;
+		assert(!Edge.Conditions.empty());
+		bool ToAcceptNode = false;
+		for (auto Ite2 : Context.TempResult)
+		{
+			assert(!ToNode.has_value());
+			auto& Cond = Edge.Conditions[NextIte];
+			if (Ite2 == 1)
+			{
+				switch (Cond.PassCommand)
+				{
+				case Dfa::ConditionT::CommandE::Next:
+					NextIte = Cond.Pass;
+					break;
+				case Dfa::ConditionT::CommandE::Fail:
+					return false;
+				case Dfa::ConditionT::CommandE::ToNode:
+					ToNode = Cond.Pass;
+					break;
+				case Dfa::ConditionT::CommandE::ToAcceptNode:
+					ToNode = Cond.Pass;
+					ToAcceptNode = true;
+					break;
+				default:
+					assert(false);
+					break;
+				}
+			}
+			else if (Ite2 == 0)
+			{
+				switch (Cond.UnpassCommand)
+				{
+				case Dfa::ConditionT::CommandE::Next:
+					NextIte = Cond.Unpass;
+					break;
+				case Dfa::ConditionT::CommandE::Fail:
+					return false;
+				case Dfa::ConditionT::CommandE::ToNode:
+					ToNode = Cond.Unpass;
+					break;
+				default:
+					assert(false);
+					break;
+				}
+			}
+		}
+
+		assert(ToNode.has_value());
+
+		Context.CurNodeIndex = *ToNode;
+		Context.Record.RecordConsume(TokenIndex);
+		return !ToAcceptNode;
+	}
+
 	bool Dfa::HasAccept(DfaProcessor const& Context) const
 	{
 		auto& CurNode = Nodes[Context.CurNodeIndex];
@@ -2410,12 +3272,540 @@ namespace Potato::Reg
 		}
 	}
 
-	void DfaBinaryTableWrapper::Serilize(Misc::StructedSerilizerWritter<StandardT>& Writer, Dfa const& RefTable)
+	LazyDfa::LazyDfa(Dfa::FormatE Format, Nfa const& T1, std::size_t MaxStateCount)
+		: Format(Format), Nodes(T1.Nodes), MaxStateCount(std::max(MaxStateCount, std::size_t(3)))
 	{
-		using WriterT = Misc::StructedSerilizerWritter<StandardT>;
-		using namespace Potato::Reg::Exception;
-
-		auto OldMark = Writer.PushMark();
+		// every edge is a group, so the code points of one class are included by the same edges
+		std::vector<std::vector<Interval const*>> Groups;
+
+		for (auto& Ite : Nodes)
+		{
+			for (auto& Ite2 : Ite.Edges)
+			{
+				Groups.push_back({ &Ite2.CharSets });
+
+				for (auto& Ite3 : Ite2.Propertys)
+				{
+					switch (Ite3.Type)
+					{
+					case Nfa::EdgePropertyE::OneCounter:
+					case Nfa::EdgePropertyE::AddCounter:
+					case Nfa::EdgePropertyE::LessCounter:
+					case Nfa::EdgePropertyE::BiggerCounter:
+					{
+						auto [CIte, B] = CounterSolt.insert({ { Ite2.MaskIndex, Ite3.Index }, CounterSolt.size() });
+						if (B)
+							CounterLimit.push_back(1);
+						// the counter is saturated after the largest bound, so the state space stays finite
+						if (Ite3.Type == Nfa::EdgePropertyE::LessCounter || Ite3.Type == Nfa::EdgePropertyE::BiggerCounter)
+							CounterLimit[CIte->second] = std::max(CounterLimit[CIte->second], Ite3.Par + 1);
+						break;
+					}
+					default:
+						break;
+					}
+				}
+			}
+		}
+
+		ClassRepresent = Classes.Build(Groups);
+
+		StartupThreads.resize(CounterLimit.size() + 1, 0);
+		InsertState(StartupThreads);
+	}
+
+	void LazyDfa::ClearCache()
+	{
+		Mapping.clear();
+		States.clear();
+		Transition.clear();
+		++ClearCount;
+		InsertState(StartupThreads);
+	}
+
+	std::size_t LazyDfa::InsertState(std::vector<std::size_t> Threads)
+	{
+		auto [Ite, B] = Mapping.insert({ Threads, States.size() });
+		if (B)
+		{
+			std::size_t ThreadSize = CounterLimit.size() + 1;
+			StateT NewState;
+			for (std::size_t I = 0; I < Threads.size(); I += ThreadSize)
+			{
+				auto& NodeRef = Nodes[Threads[I]];
+				if (!NewState.Mask.has_value() && NodeRef.Accept.has_value())
+					NewState.Mask = NodeRef.Accept->Mask;
+				if (!NodeRef.Edges.empty())
+					NewState.HasEdge = true;
+			}
+			NewState.Threads = std::move(Threads);
+			States.push_back(std::move(NewState));
+			Transition.resize(States.size() * Classes.ClassCount, UnknownTransition);
+		}
+		return Ite->second;
+	}
+
+	std::size_t LazyDfa::Step(std::size_t& StateIndex, std::size_t Class)
+	{
+		auto Cached = Transition[StateIndex * Classes.ClassCount + Class];
+		if (Cached != UnknownTransition)
+			return Cached;
+
+		std::size_t ThreadSize = CounterLimit.size() + 1;
+		auto Threads = States[StateIndex].Threads;
+
+		std::vector<std::size_t> NextThreads;
+		std::vector<std::size_t> Counter;
+		std::vector<std::size_t> AcceptedMaskIndex;
+		std::optional<std::size_t> StickyAccept;
+		bool RecordAccept = false;
+		bool Stop = false;
+
+		for (std::size_t I = 0; I < Threads.size() && !Stop; I += ThreadSize)
+		{
+			auto& NodeRef = Nodes[Threads[I]];
+
+			if (!StickyAccept.has_value() && NodeRef.Accept.has_value())
+				StickyAccept = Threads[I];
+
+			for (auto& Ite : NodeRef.Edges)
+			{
+				bool ToAccept = Nodes[Ite.ToNode].Accept.has_value();
+
+				if (!(ToAccept && Format != Dfa::FormatE::Match) && (Class == 0 || !Ite.CharSets.IsInclude(ClassRepresent[Class])))
+					continue;
+
+				if (std::find(AcceptedMaskIndex.begin(), AcceptedMaskIndex.end(), Ite.MaskIndex) != AcceptedMaskIndex.end())
+					continue;
+
+				Counter.assign(Threads.begin() + I + 1, Threads.begin() + I + ThreadSize);
+
+				bool Pass = true;
+				for (auto& Ite2 : Ite.Propertys)
+				{
+					switch (Ite2.Type)
+					{
+					case Nfa::EdgePropertyE::OneCounter:
+						Counter[CounterSolt[{Ite.MaskIndex, Ite2.Index}]] = 1;
+						break;
+					case Nfa::EdgePropertyE::AddCounter:
+					{
+						auto Solt = CounterSolt[{Ite.MaskIndex, Ite2.Index}];
+						Counter[Solt] = std::min(Counter[Solt] + 1, CounterLimit[Solt]);
+						break;
+					}
+					case Nfa::EdgePropertyE::LessCounter:
+						if (Counter[CounterSolt[{Ite.MaskIndex, Ite2.Index}]] > Ite2.Par)
+							Pass = false;
+						break;
+					case Nfa::EdgePropertyE::BiggerCounter:
+						if (Counter[CounterSolt[{Ite.MaskIndex, Ite2.Index}]] < Ite2.Par)
+							Pass = false;
+						break;
+					default:
+						break;
+					}
+					if (!Pass)
+						break;
+				}
+
+				if (!Pass)
+					continue;
+
+				if (ToAccept)
+				{
+					std::fill(Counter.begin(), Counter.end(), 0);
+					RecordAccept = true;
+					// an accepted thread kills the threads with lower priority, only the one of the same pattern in greedy mode
+					if (Format == Dfa::FormatE::GreedyHeadMatch)
+						AcceptedMaskIndex.push_back(Ite.MaskIndex);
+					else
+						Stop = true;
+				}
+
+				bool Exist = false;
+				for (std::size_t I2 = 0; I2 < NextThreads.size(); I2 += ThreadSize)
+				{
+					if (NextThreads[I2] == Ite.ToNode && std::equal(Counter.begin(), Counter.end(), NextThreads.begin() + I2 + 1))
+					{
+						Exist = true;
+						break;
+					}
+				}
+
+				if (!Exist)
+				{
+					NextThreads.push_back(Ite.ToNode);
+					NextThreads.insert(NextThreads.end(), Counter.begin(), Counter.end());
+				}
+
+				if (Stop)
+					break;
+			}
+		}
+
+		if (NextThreads.empty())
+		{
+			Transition[StateIndex * Classes.ClassCount + Class] = DeadTransition;
+			return DeadTransition;
+		}
+
+		if (StickyAccept.has_value() && Format != Dfa::FormatE::Match)
+		{
+			bool ExistAccept = false;
+			for (std::size_t I = 0; I < NextThreads.size(); I += ThreadSize)
+			{
+				if (Nodes[NextThreads[I]].Accept.has_value())
+				{
+					ExistAccept = true;
+					break;
+				}
+			}
+			if (!ExistAccept)
+			{
+				NextThreads.push_back(*StickyAccept);
+				NextThreads.resize(NextThreads.size() + ThreadSize - 1, 0);
+			}
+		}
+
+		if (!Mapping.contains(NextThreads) && States.size() >= MaxStateCount)
+		{
+			ClearCache();
+			StateIndex = InsertState(std::move(Threads));
+		}
+
+		auto Target = InsertState(std::move(NextThreads));
+		auto Entry = (Target << 1) | (RecordAccept ? 1 : 0);
+		Transition[StateIndex * Classes.ClassCount + Class] = Entry;
+		return Entry;
+	}
+
+	bool LazyDfa::Consume(DfaProcessor& Context, CodePointT Token, std::size_t TokenIndex)
+	{
+		auto Entry = Step(Context.CurNodeIndex, Classes.Locate(Token));
+		if (Entry == DeadTransition)
+			return false;
+		Context.CurNodeIndex = (Entry >> 1);
+		if ((Entry & 1) != 0)
+			Context.Record.Accept(TokenIndex);
+		Context.Record.RecordConsume(TokenIndex);
+		return States[Context.CurNodeIndex].HasEdge;
+	}
+
+	bool LazyDfa::HasAccept(DfaProcessor const& Context) const
+	{
+		return States[Context.CurNodeIndex].Mask.has_value();
+	}
+
+	ProcessorAcceptRef LazyDfa::GetAccept(DfaProcessor const& Context) const
+	{
+		auto& CurState = States[Context.CurNodeIndex];
+		ProcessorAcceptRef NewAccept;
+		if (CurState.Mask.has_value())
+		{
+			NewAccept.Mask = *CurState.Mask;
+			NewAccept.MainCapture = Context.Record.GetAcceptCapture(true);
+		}
+		else {
+			NewAccept.MainCapture = Context.Record.GetAcceptCapture(false);
+		}
+		return NewAccept;
+	}
+
+	std::variant<Dfa, LazyDfa> CreateHybridDfa(Dfa::FormatE Format, Nfa const& T1, std::size_t MaxStateCount, std::size_t MaxLazyStateCount)
+	{
+		try {
+			return std::variant<Dfa, LazyDfa>{ std::in_place_index<0>, Format, T1, 1, MaxStateCount };
+		}
+		catch (RegexOutOfRange const& Error)
+		{
+			if (Error.Type != RegexOutOfRange::TypeT::StateCount)
+				throw;
+		}
+		return std::variant<Dfa, LazyDfa>{ std::in_place_index<1>, Format, T1, MaxLazyStateCount };
+	}
+
+	bool BitParallelNfa::IsAvailable(Nfa const& T1)
+	{
+		if (T1.Unanchored)
+			return false;
+		std::size_t EdgeCount = 0;
+		for (auto& Ite : T1.Nodes)
+		{
+			EdgeCount += Ite.Edges.size();
+			for (auto& Ite2 : Ite.Edges)
+			{
+				for (auto& Ite3 : Ite2.Propertys)
+				{
+					switch (Ite3.Type)
+					{
+					case Nfa::EdgePropertyE::OneCounter:
+					case Nfa::EdgePropertyE::AddCounter:
+					case Nfa::EdgePropertyE::LessCounter:
+					case Nfa::EdgePropertyE::BiggerCounter:
+						return false;
+					default:
+						break;
+					}
+				}
+			}
+		}
+		return EdgeCount <= MaxPositionCount;
+	}
+
+	BitParallelNfa::BitParallelNfa(Nfa const& T1)
+	{
+		assert(IsAvailable(T1));
+
+		auto& Nodes = T1.Nodes;
+
+		// position 0 is the startup position, the edges of Nodes[I] take the positions [NodeFirstPosition[I], NodeFirstPosition[I + 1]).
+		std::vector<std::size_t> NodeFirstPosition;
+		NodeFirstPosition.reserve(Nodes.size() + 1);
+		PositionCount = 1;
+		for (auto& Ite : Nodes)
+		{
+			NodeFirstPosition.push_back(PositionCount);
+			PositionCount += Ite.Edges.size();
+		}
+		NodeFirstPosition.push_back(PositionCount);
+
+		auto NodePositions = [&](std::size_t NodeIndex) -> std::uint64_t {
+			auto Count = NodeFirstPosition[NodeIndex + 1] - NodeFirstPosition[NodeIndex];
+			if (Count == 0)
+				return 0;
+			return ((std::numeric_limits<std::uint64_t>::max() >> (64 - Count)) << NodeFirstPosition[NodeIndex]);
+		};
+
+		std::vector<std::uint64_t> PositionFollow;
+		PositionFollow.reserve(PositionCount);
+		PositionFollow.push_back(NodePositions(0));
+		Accepts.resize(PositionCount);
+
+		// every position is a group, the position set which includes the class is the signature of the class
+		std::vector<std::vector<Interval const*>> Groups;
+		Groups.reserve(PositionCount - 1);
+
+		std::size_t Position = 1;
+		for (auto& Ite : Nodes)
+		{
+			for (auto& Ite2 : Ite.Edges)
+			{
+				auto& ToNode = Nodes[Ite2.ToNode];
+				PositionFollow.push_back(NodePositions(Ite2.ToNode));
+				if (!ToNode.Edges.empty())
+					EdgePositions |= (std::uint64_t(1) << Position);
+				if (ToNode.Accept.has_value())
+				{
+					AcceptPositions |= (std::uint64_t(1) << Position);
+					Accepts[Position] = { ToNode.Accept->Mask, ToNode.Accept->MaskIndex };
+				}
+				Groups.push_back({ &Ite2.CharSets });
+				++Position;
+			}
+		}
+
+		std::vector<std::size_t> PositionHit;
+		Classes.Build(Groups, &PositionHit);
+
+		ClassPositions.resize(Classes.ClassCount, 0);
+		for (std::size_t Group = 0; Group < Groups.size(); ++Group)
+		{
+			for (std::size_t Class = 0; Class < Classes.ClassCount; ++Class)
+			{
+				if (PositionHit[Group * Classes.ClassCount + Class] != CharClassTable::NoEdge)
+					ClassPositions[Class] |= (std::uint64_t(1) << (Group + 1));
+			}
+		}
+
+		std::size_t ChunkCount = (PositionCount + ChunkBits - 1) / ChunkBits;
+		FollowChunk.resize(ChunkCount * ChunkSize, 0);
+		for (std::size_t Chunk = 0; Chunk < ChunkCount; ++Chunk)
+		{
+			auto Table = std::span(FollowChunk).subspan(Chunk * ChunkSize, ChunkSize);
+			for (std::size_t Bits = 1; Bits < ChunkSize; ++Bits)
+			{
+				auto Low = Chunk * ChunkBits + std::countr_zero(Bits);
+				Table[Bits] = Table[Bits & (Bits - 1)] | (Low < PositionCount ? PositionFollow[Low] : 0);
+			}
+		}
+	}
+
+	std::uint64_t BitParallelNfa::Follow(std::uint64_t State) const
+	{
+		std::uint64_t Result = 0;
+		for (auto Ite = FollowChunk.begin(); State != 0; State >>= ChunkBits, Ite += ChunkSize)
+			Result |= Ite[State & (ChunkSize - 1)];
+		return Result;
+	}
+
+	bool BitParallelNfa::Consume(DfaProcessor& Context, CodePointT Token, std::size_t TokenIndex) const
+	{
+		auto Next = Follow(Context.PositionState) & ClassPositions[Classes.Locate(Token)];
+		if (Next == 0)
+			return false;
+		Context.PositionState = Next;
+		if ((Next & AcceptPositions) != 0)
+			Context.Record.Accept(TokenIndex);
+		Context.Record.RecordConsume(TokenIndex);
+		return (Next & EdgePositions) != 0;
+	}
+
+	bool BitParallelNfa::HasAccept(DfaProcessor const& Context) const
+	{
+		return (Context.PositionState & AcceptPositions) != 0;
+	}
+
+	ProcessorAcceptRef BitParallelNfa::GetAccept(DfaProcessor const& Context) const
+	{
+		ProcessorAcceptRef NewAccept;
+		auto Accepted = Context.PositionState & AcceptPositions;
+		if (Accepted != 0)
+		{
+			// the pattern which is appended first wins
+			std::optional<AcceptT> Best;
+			for (; Accepted != 0; Accepted &= (Accepted - 1))
+			{
+				auto& Cur = Accepts[std::countr_zero(Accepted)];
+				if (!Best.has_value() || Cur.MaskIndex < Best->MaskIndex)
+					Best = Cur;
+			}
+			NewAccept.Mask = Best->Mask;
+			NewAccept.MainCapture = Context.Record.GetAcceptCapture(true);
+		}
+		else {
+			NewAccept.MainCapture = Context.Record.GetAcceptCapture(false);
+		}
+		return NewAccept;
+	}
+
+	bool ReverseDfa::IsAvailable(Nfa const& T1)
+	{
+		for (auto& Ite : T1.Nodes)
+		{
+			for (auto& Ite2 : Ite.Edges)
+			{
+				if (Ite2.HasCounter())
+					return false;
+			}
+		}
+		return true;
+	}
+
+	ReverseDfa::ReverseDfa(Nfa const& T1)
+	{
+		assert(IsAvailable(T1));
+
+		auto& Nodes = T1.Nodes;
+
+		// the implicit '.*?' of an unanchored Nfa only lives in node 0, node 1 is the startup node of the patterns.
+		std::size_t StartupNode = T1.Unanchored ? 1 : 0;
+
+		struct ReverseEdgeT
+		{
+			std::size_t FromNode;
+			Interval CharSets;
+		};
+
+		// ReverseEdges[I] are the edges which jump to Nodes[I], the edges to the accept node become the startup of the reverse Dfa.
+		std::vector<std::vector<ReverseEdgeT>> ReverseEdges;
+		ReverseEdges.resize(Nodes.size());
+		std::map<std::size_t, std::vector<std::size_t>> MaskStartup;
+
+		for (std::size_t I = StartupNode; I < Nodes.size(); ++I)
+		{
+			for (auto& Ite : Nodes[I].Edges)
+			{
+				auto& ToNode = Nodes[Ite.ToNode];
+				if (ToNode.Accept.has_value())
+				{
+					MaskStartup[ToNode.Accept->Mask].push_back(I);
+				}
+				else {
+					ReverseEdges[Ite.ToNode].push_back({ I, Ite.CharSets });
+				}
+			}
+		}
+
+		// every reverse edge is a group, so the code points of one class are included by the same reverse edges
+		std::vector<std::vector<Interval const*>> Groups;
+		for (auto& Ite : ReverseEdges)
+		{
+			for (auto& Ite2 : Ite)
+				Groups.push_back({ &Ite2.CharSets });
+		}
+
+		auto ClassRepresent = Classes.Build(Groups);
+
+		std::map<std::vector<std::size_t>, std::size_t> Mapping;
+		std::vector<std::vector<std::size_t>> States;
+
+		auto InsertState = [&](std::vector<std::size_t> NodeSet) -> std::size_t {
+			std::sort(NodeSet.begin(), NodeSet.end());
+			NodeSet.erase(std::unique(NodeSet.begin(), NodeSet.end()), NodeSet.end());
+			auto [Ite, B] = Mapping.insert({ NodeSet, States.size() });
+			if (B)
+			{
+				Accepts.push_back(std::binary_search(NodeSet.begin(), NodeSet.end(), StartupNode));
+				States.push_back(std::move(NodeSet));
+			}
+			return Ite->second;
+		};
+
+		// the empty node set is the dead state
+		InsertState({});
+		assert(States.size() == DeadState + 1);
+
+		for (auto& Ite : MaskStartup)
+			Startups.push_back({ Ite.first, InsertState(Ite.second) });
+
+		std::vector<std::size_t> NextSet;
+		for (std::size_t State = 0; State < States.size(); ++State)
+		{
+			Transition.resize((State + 1) * Classes.ClassCount, DeadState);
+			for (std::size_t Class = 1; Class < Classes.ClassCount; ++Class)
+			{
+				NextSet.clear();
+				for (auto Ite : States[State])
+				{
+					for (auto& Ite2 : ReverseEdges[Ite])
+					{
+						if (Ite2.CharSets.IsInclude(ClassRepresent[Class]))
+							NextSet.push_back(Ite2.FromNode);
+					}
+				}
+				if (!NextSet.empty())
+				{
+					auto Next = InsertState(NextSet);
+					Transition[State * Classes.ClassCount + Class] = Next;
+				}
+			}
+		}
+	}
+
+	std::size_t ReverseDfa::GetStartupState(std::size_t Mask) const
+	{
+		for (auto& Ite : Startups)
+		{
+			if (Ite.Mask == Mask)
+				return Ite.State;
+		}
+		return DeadState;
+	}
+
+	std::optional<DfaBinaryTableWrapper> DfaBinaryTableWrapper::FromContainer(std::span<StandardT const> Buffer, bool VerifyChecksum)
+	{
+		if (Misc::BinaryTableContainer::Check(Buffer, ContainerTag, ContainerVersion, VerifyChecksum) != Misc::BinaryTableContainer::CheckResultE::Ok)
+			return std::nullopt;
+		return DfaBinaryTableWrapper{ Misc::BinaryTableContainer::GetTable(Buffer) };
+	}
+
+	void DfaBinaryTableWrapper::Serilize(Misc::StructedSerilizerWritter<StandardT>& Writer, Dfa const& RefTable)
+	{
+		using WriterT = Misc::StructedSerilizerWritter<StandardT>;
+		using namespace Potato::Reg::Exception;
+
+		auto OldMark = Writer.PushMark();
 
 		HeadT Head;
 
@@ -2431,10 +3821,15 @@ namespace Potato::Reg
 
 		std::vector<BackwardReference> EdgeReference;
 		std::vector<BackwardReference> ConditionReference;
+		std::vector<HalfStandardT> EdgeOffset;
+		std::vector<HalfStandardT> TransitionRow;
 		
-		for (auto& Ite : RefTable.Nodes)
+		for (std::size_t NodeIndex = 0; NodeIndex < RefTable.Nodes.size(); ++NodeIndex)
 		{
+			auto& Ite = RefTable.Nodes[NodeIndex];
+
 			EdgeReference.clear();
+			EdgeOffset.clear();
 
 			NodeT NewNode;
 
@@ -2474,6 +3869,11 @@ namespace Potato::Reg
 				Misc::CrossTypeSetThrow<RegexOutOfRange>(NewEdge.PropertyCount, CurEdge.Propertys.size(), RegexOutOfRange::TypeT::PropertyCount, CurEdge.Propertys.size());
 				Misc::CrossTypeSetThrow<RegexOutOfRange>(NewEdge.ConditionCount, CurEdge.Conditions.size(), RegexOutOfRange::TypeT::ConditionCount, CurEdge.Conditions.size());
 				auto EdgeAdress = Writer.WriteObject(NewEdge);
+				{
+					HalfStandardT RelativeEdgeOffset = 0;
+					Misc::CrossTypeSetThrow<RegexOutOfRange>(RelativeEdgeOffset, EdgeAdress - NodeAdress, RegexOutOfRange::TypeT::NodeOffset, EdgeAdress - NodeAdress);
+					EdgeOffset.push_back(RelativeEdgeOffset);
+				}
 				auto Reader = Writer.GetReader();
 				if (Reader.has_value())
 				{
@@ -2591,7 +3991,84 @@ namespace Potato::Reg
 					N->AcceptOffset = static_cast<HalfStandardT>(Adress - NodeAdress);
 				}
 			}
-		}
+
+			if (RefTable.HasClassTable())
+			{
+				auto Row = std::span(RefTable.ClassTransition).subspan(NodeIndex * RefTable.Classes.ClassCount, RefTable.Classes.ClassCount);
+				TransitionRow.clear();
+				for (auto EdgeIndex : Row)
+					TransitionRow.push_back(EdgeIndex == CharClassTable::NoEdge ? 0 : EdgeOffset[EdgeIndex]);
+				auto RowAdress = Writer.WriteObjectArray(std::span(TransitionRow));
+				auto Reader = Writer.GetReader();
+				if (Reader.has_value())
+				{
+					Reader->SetPointer(NodeAdress);
+					auto N = Reader->ReadObject<NodeT>();
+					Misc::CrossTypeSetThrow<RegexOutOfRange>(N->TransitionOffset, RowAdress, RegexOutOfRange::TypeT::NodeOffset, RowAdress);
+				}
+			}
+		}
+
+		std::size_t ClassTableAdress = 0;
+
+		if (RefTable.HasClassTable())
+		{
+			auto& Classes = RefTable.Classes;
+			CharClassHeadT ClassHead;
+			Misc::CrossTypeSetThrow<RegexOutOfRange>(ClassHead.ClassCount, Classes.ClassCount, RegexOutOfRange::TypeT::ClassCount, Classes.ClassCount);
+			Misc::CrossTypeSetThrow<RegexOutOfRange>(ClassHead.SparseCount, Classes.SparseStart.size(), RegexOutOfRange::TypeT::ClassCount, Classes.SparseStart.size());
+			ClassTableAdress = Writer.WriteObject(ClassHead);
+
+			std::array<HalfStandardT, CharClassTable::DenseCount> Dense;
+			for (std::size_t I = 0; I < Dense.size(); ++I)
+				Misc::CrossTypeSetThrow<RegexOutOfRange>(Dense[I], Classes.Dense[I], RegexOutOfRange::TypeT::ClassCount, Classes.Dense[I]);
+			Writer.WriteObjectArray(std::span(Dense));
+
+			for (std::size_t I = 0; I < Classes.SparseStart.size(); ++I)
+			{
+				CharClassSparseT Sparse;
+				Sparse.Start = Classes.SparseStart[I];
+				Misc::CrossTypeSetThrow<RegexOutOfRange>(Sparse.Class, Classes.SparseClass[I], RegexOutOfRange::TypeT::ClassCount, Classes.SparseClass[I]);
+				Writer.WriteObject(Sparse);
+			}
+		}
+
+		std::size_t Utf8TableAdress = 0;
+
+		if (RefTable.HasUtf8Table())
+		{
+			auto& Utf8 = RefTable.Utf8;
+			Utf8HeadT Utf8Head;
+			Misc::CrossTypeSetThrow<RegexOutOfRange>(Utf8Head.StateCount, Utf8.StateCount, RegexOutOfRange::TypeT::ClassCount, Utf8.StateCount);
+			Utf8TableAdress = Writer.WriteObject(Utf8Head);
+
+			std::vector<StandardT> Entrys;
+			Entrys.reserve(Utf8.Root.size() + Utf8.Continuation.size());
+			for (auto Ite : Utf8.Root)
+			{
+				StandardT Entry = 0;
+				Misc::CrossTypeSetThrow<RegexOutOfRange>(Entry, Ite, RegexOutOfRange::TypeT::ClassCount, Ite);
+				Entrys.push_back(Entry);
+			}
+			for (auto Ite : Utf8.Continuation)
+			{
+				StandardT Entry = 0;
+				Misc::CrossTypeSetThrow<RegexOutOfRange>(Entry, Ite, RegexOutOfRange::TypeT::ClassCount, Ite);
+				Entrys.push_back(Entry);
+			}
+			Writer.WriteObjectArray(std::span(Entrys));
+		}
+
+		std::size_t PrefilterAdress = 0;
+
+		{
+			PrefilterT Pre;
+			for (std::size_t I = 0; I < Pre.StartByte.size(); ++I)
+				Pre.StartByte[I] = RefTable.PrefilterStartByte[I];
+			Misc::CrossTypeSetThrow<RegexOutOfRange>(Pre.PrefixSize, RefTable.PrefilterPrefix.size(), RegexOutOfRange::TypeT::NodeOffset, RefTable.PrefilterPrefix.size());
+			PrefilterAdress = Writer.WriteObject(Pre);
+			Writer.WriteObjectArray(std::span(RefTable.PrefilterPrefix.data(), RefTable.PrefilterPrefix.size()));
+		}
 
 		
 		auto Reader = Writer.GetReader();
@@ -2622,168 +4099,245 @@ namespace Potato::Reg
 			Reader->SetPointer(0);
 			auto Head = Reader->ReadObject<HeadT>();
 
-			Head->Format = RefTable.Format;
+			Head->Format = static_cast<StandardT>(RefTable.Format);
 			Head->StartupNodeIndex = NodeIndexOffset[0];
 			Head->NodeCount = static_cast<StandardT>(NodeIndexOffset.size());
 			Head->CacheSolt = static_cast<StandardT>(RefTable.CacheRecordCount);
 			Head->TempResult = static_cast<StandardT>(RefTable.ResultCount);
+			Head->Unanchored = RefTable.Unanchored ? 1 : 0;
+			Head->CaptureFree = RefTable.CaptureFree ? 1 : 0;
+			Misc::CrossTypeSetThrow<RegexOutOfRange>(Head->ClassTableOffset, ClassTableAdress, RegexOutOfRange::TypeT::NodeOffset, ClassTableAdress);
+			Misc::CrossTypeSetThrow<RegexOutOfRange>(Head->Utf8TableOffset, Utf8TableAdress, RegexOutOfRange::TypeT::NodeOffset, Utf8TableAdress);
+			Misc::CrossTypeSetThrow<RegexOutOfRange>(Head->PrefilterOffset, PrefilterAdress, RegexOutOfRange::TypeT::NodeOffset, PrefilterAdress);
 		}
 
 		Writer.PopMark(OldMark);
 	}
 
+	std::size_t DfaBinaryTableWrapper::LocateClass(CodePointT Token) const
+	{
+		auto Reader = Misc::StructedSerilizerReader(Wrapper);
+		Reader.SetPointer(reinterpret_cast<HeadT const*>(Wrapper.data())->ClassTableOffset);
+		auto ClassHead = Reader.ReadObject<CharClassHeadT>();
+		auto Dense = Reader.ReadObjectArray<HalfStandardT>(CharClassTable::DenseCount);
+		if (Token < CharClassTable::DenseCount)
+			return Dense[Token];
+		auto Sparse = Reader.ReadObjectArray<CharClassSparseT>(ClassHead->SparseCount);
+		auto Ite = std::upper_bound(Sparse.begin(), Sparse.end(), Token, [](CodePointT Value, CharClassSparseT const& Ele) {
+			return Value < Ele.Start;
+		});
+		return (Ite - 1)->Class;
+	}
+
 	bool DfaBinaryTableWrapper::Consume(DfaProcessor& Context, CodePointT Token, std::size_t TokenIndex) const
 	{
 		auto Reader = Misc::StructedSerilizerReader(Wrapper);
 		Reader.SetPointer(Context.CurNodeIndex);
 		auto Node = Reader.ReadObject<DfaBinaryTableWrapper::NodeT>();
+		if (Node->TransitionOffset != 0)
+			return ConsumeClass(Context, LocateClass(Token), TokenIndex);
 		std::size_t ECount = Node->EdgeCount;
 		for (std::size_t I = 0; I < ECount; ++I)
 		{
 			auto Pro = Reader.ReadObject<DfaBinaryTableWrapper::CharSetPropertyT>();
 			auto IntervalSpan = Reader.ReadObjectArray<Interval::ElementT>(Pro->CharCount);
 			if (Misc::IntervalWrapperT<CodePointT>::IsInclude(IntervalSpan, Token))
-			{
-				Reader.SetPointer(Context.CurNodeIndex + Pro->EdgeOffset);
-				auto Edge = Reader.ReadObject<DfaBinaryTableWrapper::EdgeT>();
-				std::size_t ECount = Edge->PropertyCount;
-				std::size_t CCount = Edge->ConditionCount;
-				Context.TempResult.clear();
-				bool DetectResult = true;
-				for (std::size_t I2 = 0; I2 < ECount; ++I2)
-				{
-					auto Action = static_cast<Dfa::PropertyActioE>(*Reader.ReadObject<DfaBinaryTableWrapper::StandardT>());
-					switch (Action)
-					{
-					case Dfa::PropertyActioE::CopyValue:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						auto P2 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if(DetectResult)
-							Context.CacheIndex[P2] = Context.CacheIndex[P1];
-						break;
-					}
-					case Dfa::PropertyActioE::RecordLocation:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if(DetectResult)
-							Context.CacheIndex[P1] = TokenIndex;
-						break;
-					}
-					case Dfa::PropertyActioE::NewContext:
-					{
-						Context.TempResult.push_back(DetectResult ? 1 : 0);
-						DetectResult = true;
-						break;
-					}
-					case Dfa::PropertyActioE::ConstraintsTrueTrue:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if (DetectResult && Context.TempResult[P1])
-							DetectResult = true;
-						break;
-					}
-					case Dfa::PropertyActioE::ConstraintsFalseFalse:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if (DetectResult && !Context.TempResult[P1])
-							DetectResult = false;
-						break;
-					}
-					case Dfa::PropertyActioE::ConstraintsFalseTrue:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if (DetectResult && !Context.TempResult[P1])
-							DetectResult = true;
-						break;
-					}
-					case Dfa::PropertyActioE::ConstraintsTrueFalse:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if (DetectResult && Context.TempResult[P1])
-							DetectResult = false;
-						break;
-					}
-					case Dfa::PropertyActioE::OneCounter:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if (DetectResult)
-							Context.CacheIndex[P1] = 1;
-						break;
-					}
-					case Dfa::PropertyActioE::AddCounter:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if (DetectResult)
-							Context.CacheIndex[P1] += 1;
-						break;
-					}
-					case Dfa::PropertyActioE::LessCounter:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						auto P2 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if (DetectResult && Context.CacheIndex[P1] > P2)
-							DetectResult = false;
-						break;
-					}
-					case Dfa::PropertyActioE::BiggerCounter:
-					{
-						auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						auto P2 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
-						if (DetectResult && Context.CacheIndex[P1] < P2)
-							DetectResult = false;
-						break;
-					}
-					case Dfa::PropertyActioE::RecordAcceptLocation:
-						Context.Record.Accept(TokenIndex);
-						break;
-					default:
-						assert(false);
-						break;
-					}
-				}
+				return ConsumeEdge(Context, Context.CurNodeIndex + Pro->EdgeOffset, TokenIndex);
+		}
+		return false;
+	}
 
+	bool DfaBinaryTableWrapper::ConsumeClass(DfaProcessor& Context, std::size_t Class, std::size_t TokenIndex) const
+	{
+		auto Node = reinterpret_cast<NodeT const*>(Wrapper.data() + Context.CurNodeIndex);
+		auto Row = reinterpret_cast<HalfStandardT const*>(Wrapper.data() + Node->TransitionOffset);
+		auto EdgeOffset = Row[Class];
+		if (EdgeOffset != 0)
+			return ConsumeEdge(Context, Context.CurNodeIndex + EdgeOffset, TokenIndex);
+		return false;
+	}
+
+	Prefilter DfaBinaryTableWrapper::GetPrefilter() const
+	{
+		Prefilter Filter;
+		auto Offset = reinterpret_cast<HeadT const*>(Wrapper.data())->PrefilterOffset;
+		if (Offset == 0)
+		{
+			Filter.StartByte.fill(std::numeric_limits<std::uint32_t>::max());
+			return Filter;
+		}
+		auto Reader = Misc::StructedSerilizerReader(Wrapper);
+		Reader.SetPointer(Offset);
+		auto Pre = Reader.ReadObject<PrefilterT>();
+		for (std::size_t I = 0; I < Filter.StartByte.size(); ++I)
+			Filter.StartByte[I] = Pre->StartByte[I];
+		auto Prefix = Reader.ReadObjectArray<char8_t>(Pre->PrefixSize);
+		Filter.Prefix = std::u8string_view{ Prefix.data(), Prefix.size() };
+		return Filter;
+	}
+
+	std::size_t DfaBinaryTableWrapper::Utf8Step(std::size_t State, char8_t Byte) const
+	{
+		auto Table = Wrapper.data() + reinterpret_cast<HeadT const*>(Wrapper.data())->Utf8TableOffset + sizeof(Utf8HeadT) / sizeof(StandardT);
+		if (State == 0)
+			return Table[Byte];
+		if (Byte < 0x80 || Byte >= 0xC0)
+			return Utf8ClassTable::InvalidEntry;
+		return Table[Utf8ClassTable::RootCount + (State - 1) * Utf8ClassTable::ContinuationCount + (Byte - 0x80)];
+	}
+
+	bool DfaBinaryTableWrapper::ConsumeEdge(DfaProcessor& Context, std::size_t EdgeAdress, std::size_t TokenIndex) const
+	{
+		if (IsCaptureFree())
+		{
+			auto Edge = reinterpret_cast<EdgeT const*>(Wrapper.data() + EdgeAdress);
+			if (Edge->PropertyCount != 0)
+				Context.Record.Accept(TokenIndex);
+			auto Cond = reinterpret_cast<ConditionT const*>(Wrapper.data() + EdgeAdress + sizeof(EdgeT) / sizeof(StandardT) + Edge->PropertyCount);
+			Context.CurNodeIndex = Cond->Pass;
+			Context.Record.RecordConsume(TokenIndex);
+			return static_cast<Dfa::ConditionT::CommandE>(Cond->PassCommand) != Dfa::ConditionT::CommandE::ToAcceptNode;
+		}
+
+		auto Reader = Misc::StructedSerilizerReader(Wrapper);
+		Reader.SetPointer(EdgeAdress);
+		auto Edge = Reader.ReadObject<DfaBinaryTableWrapper::EdgeT>();
+		std::size_t ECount = Edge->PropertyCount;
+		std::size_t CCount = Edge->ConditionCount;
+		Context.TempResult.clear();
+		bool DetectResult = true;
+		for (std::size_t I2 = 0; I2 < ECount; ++I2)
+		{
+			auto Action = static_cast<Dfa::PropertyActioE>(*Reader.ReadObject<DfaBinaryTableWrapper::StandardT>());
+			switch (Action)
+			{
+			case Dfa::PropertyActioE::CopyValue:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				auto P2 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if(DetectResult)
+					Context.CacheIndex[P2] = Context.CacheIndex[P1];
+				break;
+			}
+			case Dfa::PropertyActioE::RecordLocation:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if(DetectResult)
+					Context.CacheIndex[P1] = TokenIndex;
+				break;
+			}
+			case Dfa::PropertyActioE::NewContext:
+			{
 				Context.TempResult.push_back(DetectResult ? 1 : 0);
-				auto ConditionSpan = Reader.ReadObjectArray<DfaBinaryTableWrapper::ConditionT>(Edge->ConditionCount);
-				std::size_t LastCondition = 0;
-				for (auto Ite : Context.TempResult)
-				{
-					auto CurCondition = ConditionSpan[LastCondition];
-					auto TarCommand = Dfa::ConditionT::CommandE::Fail;
-					std::size_t Solt = 0;
-					if (Ite == 1)
-					{
-						TarCommand = static_cast<Dfa::ConditionT::CommandE>(CurCondition.PassCommand);
-						Solt = CurCondition.Pass;
-					}
-					else {
-						TarCommand = static_cast<Dfa::ConditionT::CommandE>(CurCondition.UnpassCommand);
-						Solt = CurCondition.Unpass;
-					}
-					switch (TarCommand)
-					{
-					case Dfa::ConditionT::CommandE::Next:
-						LastCondition = Solt;
-						break;
-					case Dfa::ConditionT::CommandE::ToNode:
-					{
-						Context.CurNodeIndex = Solt;
-						Context.Record.RecordConsume(TokenIndex);
-						return true;
-					}
-					case Dfa::ConditionT::CommandE::ToAcceptNode:
-					{
-						Context.CurNodeIndex = Solt;
-						Context.Record.RecordConsume(TokenIndex);
-						return false;
-					}
-					case Dfa::ConditionT::CommandE::Fail:
-						return false;
-					default:
-						assert(false);
-						return false;
-					}
-				}
+				DetectResult = true;
+				break;
+			}
+			case Dfa::PropertyActioE::ConstraintsTrueTrue:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if (DetectResult && Context.TempResult[P1])
+					DetectResult = true;
+				break;
+			}
+			case Dfa::PropertyActioE::ConstraintsFalseFalse:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if (DetectResult && !Context.TempResult[P1])
+					DetectResult = false;
+				break;
+			}
+			case Dfa::PropertyActioE::ConstraintsFalseTrue:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if (DetectResult && !Context.TempResult[P1])
+					DetectResult = true;
+				break;
+			}
+			case Dfa::PropertyActioE::ConstraintsTrueFalse:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if (DetectResult && Context.TempResult[P1])
+					DetectResult = false;
+				break;
+			}
+			case Dfa::PropertyActioE::OneCounter:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if (DetectResult)
+					Context.CacheIndex[P1] = 1;
+				break;
+			}
+			case Dfa::PropertyActioE::AddCounter:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if (DetectResult)
+					Context.CacheIndex[P1] += 1;
+				break;
+			}
+			case Dfa::PropertyActioE::LessCounter:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				auto P2 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if (DetectResult && Context.CacheIndex[P1] > P2)
+					DetectResult = false;
+				break;
+			}
+			case Dfa::PropertyActioE::BiggerCounter:
+			{
+				auto P1 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				auto P2 = *Reader.ReadObject<DfaBinaryTableWrapper::StandardT>();
+				if (DetectResult && Context.CacheIndex[P1] < P2)
+					DetectResult = false;
+				break;
+			}
+			case Dfa::PropertyActioE::RecordAcceptLocation:
+				Context.Record.Accept(TokenIndex);
+				break;
+			default:
+				assert(false);
+				break;
+			}
+		}
+
+		Context.TempResult.push_back(DetectResult ? 1 : 0);
+		auto ConditionSpan = Reader.ReadObjectArray<DfaBinaryTableWrapper::ConditionT>(Edge->ConditionCount);
+		std::size_t LastCondition = 0;
+		for (auto Ite : Context.TempResult)
+		{
+			auto CurCondition = ConditionSpan[LastCondition];
+			auto TarCommand = Dfa::ConditionT::CommandE::Fail;
+			std::size_t Solt = 0;
+			if (Ite == 1)
+			{
+				TarCommand = static_cast<Dfa::ConditionT::CommandE>(CurCondition.PassCommand);
+				Solt = CurCondition.Pass;
+			}
+			else {
+				TarCommand = static_cast<Dfa::ConditionT::CommandE>(CurCondition.UnpassCommand);
+				Solt = CurCondition.Unpass;
+			}
+			switch (TarCommand)
+			{
+			case Dfa::ConditionT::CommandE::Next:
+				LastCondition = Solt;
+				break;
+			case Dfa::ConditionT::CommandE::ToNode:
+			{
+				Context.CurNodeIndex = Solt;
+				Context.Record.RecordConsume(TokenIndex);
+				return true;
+			}
+			case Dfa::ConditionT::CommandE::ToAcceptNode:
+			{
+				Context.CurNodeIndex = Solt;
+				Context.Record.RecordConsume(TokenIndex);
+				return false;
+			}
+			case Dfa::ConditionT::CommandE::Fail:
+				return false;
+			default:
+				assert(false);
+				return false;
 			}
 		}
 		return false;
@@ -2820,6 +4374,376 @@ namespace Potato::Reg
 		}
 	}
 
+	LiteralTable::LiteralTable(std::span<LiteralT const> Literals)
+	{
+		struct TrieNodeT
+		{
+			std::vector<std::tuple<char8_t, std::size_t>> Childs;
+			std::optional<std::size_t> Accept;
+		};
+
+		std::vector<TrieNodeT> Trie;
+		Trie.push_back({});
+
+		for (auto& Ite : Literals)
+		{
+			std::size_t Cur = 0;
+			for (auto Ite2 : Ite.Literal)
+			{
+				auto Find = std::find_if(Trie[Cur].Childs.begin(), Trie[Cur].Childs.end(), [=](auto const& C) { return std::get<0>(C) == Ite2; });
+				if (Find != Trie[Cur].Childs.end())
+					Cur = std::get<1>(*Find);
+				else {
+					Trie[Cur].Childs.push_back({ Ite2, Trie.size() });
+					Cur = Trie.size();
+					Trie.push_back({});
+				}
+			}
+			if (!Trie[Cur].Accept.has_value())
+			{
+				Trie[Cur].Accept = Accepts.size();
+				Accepts.push_back({ Ite.Mask, Ite.Priority, 0 });
+			}
+		}
+
+		if (Accepts.empty())
+			return;
+
+		Base.resize(1, 0);
+		Check.resize(1, NoCheck);
+		AcceptIndex.resize(1, 0);
+
+		std::vector<std::tuple<std::size_t, std::size_t>> SearchingStack;
+		SearchingStack.push_back({ 0, 0 });
+		std::size_t FirstFree = 1;
+
+		while (!SearchingStack.empty())
+		{
+			auto [TrieIndex, Index] = *SearchingStack.rbegin();
+			SearchingStack.pop_back();
+
+			auto& Node = Trie[TrieIndex];
+			AcceptIndex[Index] = Node.Accept.has_value() ? static_cast<std::uint32_t>(*Node.Accept + 1) : 0;
+
+			if (Node.Childs.empty())
+				continue;
+
+			std::sort(Node.Childs.begin(), Node.Childs.end());
+
+			auto MinByte = static_cast<std::size_t>(std::get<0>(*Node.Childs.begin()));
+			while (FirstFree < Check.size() && Check[FirstFree] != NoCheck)
+				++FirstFree;
+
+			std::size_t NewBase = (FirstFree > MinByte) ? FirstFree - MinByte : 1;
+			while (true)
+			{
+				bool Fit = true;
+				for (auto& Ite : Node.Childs)
+				{
+					auto Tar = NewBase + std::get<0>(Ite);
+					if (Tar < Check.size() && Check[Tar] != NoCheck)
+					{
+						Fit = false;
+						break;
+					}
+				}
+				if (Fit)
+					break;
+				++NewBase;
+			}
+
+			Misc::CrossTypeSetThrow<RegexOutOfRange>(Base[Index], NewBase, RegexOutOfRange::TypeT::NodeOffset, NewBase);
+
+			auto MaxTar = NewBase + std::get<0>(*Node.Childs.rbegin());
+			if (MaxTar >= Check.size())
+			{
+				Base.resize(MaxTar + 1, 0);
+				Check.resize(MaxTar + 1, NoCheck);
+				AcceptIndex.resize(MaxTar + 1, 0);
+			}
+
+			for (auto& Ite : Node.Childs)
+			{
+				auto Tar = NewBase + std::get<0>(Ite);
+				Check[Tar] = static_cast<std::uint32_t>(Index);
+				SearchingStack.push_back({ std::get<1>(Ite), Tar });
+			}
+		}
+	}
+
+	std::optional<Nfa> MulityRegCreater::CreateNfa() const
+	{
+		std::optional<Nfa> Table;
+		for (std::size_t Index = 0; Index < Patterns.size(); ++Index)
+		{
+			auto& Ite = Patterns[Index];
+			std::optional<Nfa> Literal;
+			if (!Ite.Table.has_value())
+				Literal.emplace(std::u32string_view{ Ite.Str }, Ite.IsRaw, Index);
+			auto& Ref = Ite.Table.has_value() ? *Ite.Table : *Literal;
+			if (Table.has_value())
+				Table->Link(Ref);
+			else
+				Table.emplace(Ref);
+		}
+
+		// the patterns are parsed with the append index as the mask, map it back to the mask of the user
+		if (Table.has_value())
+		{
+			for (auto& Ite : Table->Nodes)
+			{
+				if (Ite.Accept.has_value())
+					Ite.Accept->Mask = Patterns[Ite.Accept->Mask].Mask;
+			}
+		}
+		return Table;
+	}
+
+	std::optional<MulityRegTable> MulityRegCreater::CreateMulityRegTable() const
+	{
+		if (Patterns.empty())
+			return {};
+
+		MulityRegTable Result;
+		std::optional<Nfa> RegTable;
+		for (auto& Ite : Patterns)
+		{
+			if (!Ite.Table.has_value())
+				continue;
+			if (RegTable.has_value())
+				RegTable->Link(*Ite.Table);
+			else
+				RegTable.emplace(*Ite.Table);
+		}
+		if (RegTable.has_value())
+			Result.RegTable.emplace(Dfa::FormatE::GreedyHeadMatch, *RegTable);
+
+		std::vector<LiteralTable::LiteralT> LiteralView;
+		LiteralView.reserve(Literals.size());
+		for (auto& Ite : Literals)
+			LiteralView.push_back({ Ite.Literal, Ite.Mask, Ite.Priority });
+		Result.Literals = LiteralTable{ std::span(LiteralView) };
+		Result.Masks.reserve(Patterns.size());
+		for (auto& Ite : Patterns)
+			Result.Masks.push_back(Ite.Mask);
+		return Result;
+	}
+
+	bool DfaStreamMatcher::FillBlock(std::size_t KeepOffset)
+	{
+		if (SourceEnd)
+			return false;
+
+		assert(KeepOffset >= BufferOffset && KeepOffset <= BufferOffset + Buffer.size());
+		Buffer.erase(Buffer.begin(), Buffer.begin() + (KeepOffset - BufferOffset));
+		BufferOffset = KeepOffset;
+
+		auto OldSize = Buffer.size();
+		Buffer.resize(OldSize + BlockSize);
+		auto Output = std::span(Buffer).subspan(OldSize);
+		std::size_t ReadSize = 0;
+
+		if (std::holds_alternative<std::reference_wrapper<Streamer::StreamReader>>(Source))
+		{
+			ReadSize = std::get<std::reference_wrapper<Streamer::StreamReader>>(Source).get().StreamRead(
+				reinterpret_cast<std::byte*>(Output.data()), Output.size()
+			);
+		}
+		else {
+			auto Info = std::get<std::reference_wrapper<Document::PlainTextReader>>(Source).get().ReadPlainText(Output);
+			if (Info.has_value())
+				ReadSize = Info->target_space;
+		}
+
+		Buffer.resize(OldSize + ReadSize);
+		if (ReadSize == 0)
+		{
+			SourceEnd = true;
+			return false;
+		}
+		return true;
+	}
+
+	std::u8string_view DfaStreamMatcher::GetString(Misc::IndexSpan<> Span) const
+	{
+		assert(Span.Begin() >= BufferOffset && Span.End() <= BufferOffset + Buffer.size());
+		return std::u8string_view{ Buffer.data() + (Span.Begin() - BufferOffset), Span.Size() };
+	}
+
+	bool DfaStreamMatcher::Require(std::size_t Offset, std::size_t KeepOffset)
+	{
+		while (Offset >= BufferOffset + Buffer.size())
+		{
+			if (!FillBlock(KeepOffset))
+				return false;
+		}
+		return true;
+	}
+
+	ProcessorAcceptRef DfaStreamMatcher::Next()
+	{
+		if (Finish)
+			return {};
+
+		Processor.Clear();
+		bool ByteLevel = Processor.HasUtf8Table();
+		std::size_t Offset = SearchOffset;
+		bool EndOfStream = false;
+
+		// the slots only hold the location recorded in this search, so the bytes from the earliest one are kept for the result.
+		std::fill(Processor.CacheIndex.begin(), Processor.CacheIndex.end(), NoLocation);
+
+		auto KeepOffset = [&]() -> std::size_t {
+			std::size_t Keep = (ByteLevel && Processor.Utf8State != 0) ? Processor.Utf8CharStart : Offset;
+			for (auto Ite : Processor.CacheIndex)
+				Keep = std::min(Ite, Keep);
+			return std::max(Keep, BufferOffset);
+		};
+
+		while (true)
+		{
+			if (ByteLevel)
+			{
+				if (Offset >= BufferOffset + Buffer.size() && !Require(Offset, KeepOffset()))
+				{
+					EndOfStream = true;
+					break;
+				}
+				if (!Processor.ConsumeByte(Buffer[Offset - BufferOffset], Offset))
+					break;
+				Offset += 1;
+			}
+			else {
+				if (!Require(Offset + Encode::Unicode::UTF8::max_storage_size - 1, KeepOffset()) && Offset >= BufferOffset + Buffer.size())
+				{
+					EndOfStream = true;
+					break;
+				}
+				CodePointT Temp = 0;
+				Encode::EncodeCutOffSetting Cutoff;
+				Cutoff.max_character_count = 1;
+				auto Info = Encode::UnicodeEncoder<char8_t, CodePointT>::EncodeTo(std::span(Buffer).subspan(Offset - BufferOffset), std::span(&Temp, 1), Cutoff);
+				if (Info.target_space == 0)
+					break;
+				if (!Processor.Consume(Temp, Offset))
+					break;
+				Offset += Info.source_space;
+			}
+		}
+
+		if (EndOfStream && (!ByteLevel || Processor.Utf8State == 0))
+			Processor.EndOfFile(Offset);
+
+		for (auto& Ite : Processor.CacheIndex)
+		{
+			if (Ite == NoLocation)
+				Ite = 0;
+		}
+
+		auto Accept = Processor.GetAccept();
+		if (!Accept)
+		{
+			Finish = true;
+			return {};
+		}
+
+		assert(Accept.Capture.size() >= 2);
+		Accept.MainCapture = { Accept.Capture[0], Accept.Capture[1] };
+		Accept.Capture = Accept.Capture.subspan(2);
+
+		auto End = Accept.MainCapture.End();
+		if (End > SearchOffset)
+			SearchOffset = End;
+		else {
+			// empty match, skip one character before the next search.
+			assert(End >= BufferOffset);
+			Require(End + Encode::Unicode::UTF8::max_storage_size - 1, Accept.MainCapture.Begin());
+			if (End < BufferOffset + Buffer.size())
+			{
+				CodePointT Temp = 0;
+				Encode::EncodeCutOffSetting Cutoff;
+				Cutoff.max_character_count = 1;
+				auto Info = Encode::UnicodeEncoder<char8_t, CodePointT>::EncodeTo(std::span(Buffer).subspan(End - BufferOffset), std::span(&Temp, 1), Cutoff);
+				SearchOffset = End + std::max(Info.source_space, std::size_t(1));
+			}
+			else
+				Finish = true;
+		}
+		return Accept;
+	}
+
+	std::size_t DfaTableCache::KeyHashT::operator()(KeyViewT const& Key) const
+	{
+		auto Result = std::hash<std::u8string_view>{}(Key.Pattern);
+		Result ^= std::hash<std::size_t>{}(Key.Mask) + 0x9e3779b9 + (Result << 6) + (Result >> 2);
+		Result ^= (static_cast<std::size_t>(Key.Format) << 1) | (Key.IsRaw ? 1 : 0);
+		return Result;
+	}
+
+	auto DfaTableCache::GetUtf8(Dfa::FormatE Format, std::u8string_view Str, bool IsRaw, std::size_t Mask) -> Table::Ptr
+	{
+		KeyViewT Key{ Str, Format, IsRaw, Mask };
+
+		{
+			std::lock_guard lg(Mutex);
+			auto Ite = Mapping.find(Key);
+			if (Ite != Mapping.end())
+			{
+				++Statistics.HitCount;
+				Tables.splice(Tables.begin(), Tables, Ite->second);
+				return std::get<1>(*Ite->second);
+			}
+			++Statistics.MissCount;
+		}
+
+		// compile without the lock, so a slow pattern does not block the lookup of the others,
+		// the class and UTF-8 tables are serialized too, so the cached table never falls back to the per edge scan
+		Dfa Compiled{ Format, Str, IsRaw, Mask };
+		Compiled.BuildUtf8Table();
+		Table::Ptr NewTable{ new Table{ CreateDfaBinaryTable(Compiled) } };
+
+		std::lock_guard lg(Mutex);
+		auto Ite = Mapping.find(Key);
+		if (Ite != Mapping.end())
+		{
+			// another thread compiled the same pattern in the meantime
+			Tables.splice(Tables.begin(), Tables, Ite->second);
+			return std::get<1>(*Ite->second);
+		}
+		Ite = Mapping.insert({ KeyT{ std::u8string{ Str }, Format, IsRaw, Mask }, Tables.end() }).first;
+		Tables.emplace_front(&Ite->first, NewTable);
+		Ite->second = Tables.begin();
+
+		while (Tables.size() > MaxTableCount)
+		{
+			auto Evicted = Mapping.find(*std::get<0>(Tables.back()));
+			assert(Evicted != Mapping.end());
+			Mapping.erase(Evicted);
+			Tables.pop_back();
+			++Statistics.EvictionCount;
+		}
+		return NewTable;
+	}
+
+	auto DfaTableCache::GetStatistics() const -> StatisticsT
+	{
+		std::lock_guard lg(Mutex);
+		return Statistics;
+	}
+
+	std::size_t DfaTableCache::GetTableCount() const
+	{
+		std::lock_guard lg(Mutex);
+		return Tables.size();
+	}
+
+	void DfaTableCache::Clear()
+	{
+		std::lock_guard lg(Mutex);
+		Mapping.clear();
+		Tables.clear();
+	}
+
 	namespace Exception
 	{
 		char const* Interface::what() const
@@ -9,8 +9,11 @@ import std;
 import PotatoInterval;
 import PotatoEncode;
 import PotatoMisc;
+import PotatoPointer;
 import PotatoSLRX;
 import PotatoTMP;
+import PotatoStreamer;
+import PotatoDocument;
 
 
 export namespace Potato::Reg
@@ -24,7 +27,14 @@ export namespace Potato::Reg
 
 	struct DfaBinaryTableWrapper;
 	struct Dfa;
+	struct LazyDfa;
+	struct BitParallelNfa;
+	struct ReverseDfa;
 	struct DfaProcessor;
+	struct DfaBatchProcessor;
+	struct StaticDfaBuilder;
+	struct DfaStreamMatcher;
+	struct MulityRegCreater;
 
 	struct Nfa
 	{
@@ -40,6 +50,16 @@ export namespace Potato::Reg
 
 		void Link(Nfa const&);
 
+		// Add an implicit lazy '.*?' before the patterns, so the Dfa created from it finds the leftmost match in one pass.
+		// The match location is recorded as an implicit capture before the capture of the patterns.
+		void MakeUnanchored();
+		bool IsUnanchored() const { return Unanchored; }
+
+		// Remove the capture of the patterns, so the Dfa created from it only reports the mask and the main capture.
+		// The implicit capture of an unanchored Nfa is kept unless KeepImplicitCapture is false, the Dfa is then capture free
+		// and only finds the end of the match, the begin can be found by ReverseDfa.
+		void RemoveCapture(bool KeepImplicitCapture = true);
+
 	protected:
 
 		Nfa() = default;
@@ -161,8 +181,13 @@ export namespace Potato::Reg
 
 		std::vector<NodeT> Nodes;
 		std::size_t MaskIndex = 1;
+		bool Unanchored = false;
 
 		friend struct Dfa;
+		friend struct LazyDfa;
+		friend struct BitParallelNfa;
+		friend struct ReverseDfa;
+		friend struct MulityRegCreater;
 	};
 
 	struct NfaEdgeKeyT
@@ -274,6 +299,81 @@ export namespace Potato::Reg
 
 	struct DfaProcessor;
 
+	struct CharClassTable
+	{
+		static constexpr CodePointT DenseCount = 256;
+		static constexpr std::size_t NoEdge = std::numeric_limits<std::size_t>::max();
+
+		std::size_t ClassCount = 0;
+		std::array<std::size_t, DenseCount> Dense = {};
+		std::vector<CodePointT> SparseStart;
+		std::vector<std::size_t> SparseClass;
+
+		std::size_t Locate(CodePointT Input) const
+		{
+			if (Input < DenseCount)
+				return Dense[Input];
+			auto Ite = std::upper_bound(SparseStart.begin(), SparseStart.end(), Input);
+			return SparseClass[std::distance(SparseStart.begin(), Ite) - 1];
+		}
+
+		bool IsUniform(CodePointT Start, CodePointT End) const
+		{
+			if (Start < DenseCount)
+				return false;
+			return std::upper_bound(SparseStart.begin(), SparseStart.end(), Start) == std::upper_bound(SparseStart.begin(), SparseStart.end(), End);
+		}
+
+		// Partition the code point space by partition refinement. Every group is an ordered list of char sets and the first one
+		// which includes a code point wins, the code points which win the same char set in every group share one class.
+		// Class 0 is kept for the code points without any char set, the other classes are numbered by their first code point.
+		// Return the first code point of every class, GroupHit[Group * ClassCount + Class] is the index of the winning char set or NoEdge.
+		std::vector<CodePointT> Build(std::span<std::vector<Interval const*> const> Groups, std::vector<std::size_t>* GroupHit = nullptr);
+	};
+
+	// Byte level UTF-8 decoder which maps a byte sequence directly to a char class.
+	// Entry : 0 -> invalid sequence, odd -> (Class << 1) | 1, even -> (ContinuationState << 1), ContinuationState start from 1.
+	struct Utf8ClassTable
+	{
+		static constexpr std::size_t RootCount = 256;
+		static constexpr std::size_t ContinuationCount = 64;
+		static constexpr std::size_t InvalidEntry = 0;
+
+		std::size_t StateCount = 0;
+		std::array<std::size_t, RootCount> Root = {};
+		std::vector<std::size_t> Continuation;
+
+		static bool IsClassEntry(std::size_t Entry) { return (Entry & 1) != 0; }
+		static std::size_t GetEntryValue(std::size_t Entry) { return Entry >> 1; }
+
+		bool Empty() const { return StateCount == 0; }
+		void Build(CharClassTable const& Classes);
+
+		std::size_t Step(std::size_t State, char8_t Byte) const
+		{
+			if (State == 0)
+				return Root[Byte];
+			if (Byte < 0x80 || Byte >= 0xC0)
+				return InvalidEntry;
+			return Continuation[(State - 1) * ContinuationCount + (Byte - 0x80)];
+		}
+	};
+
+	// Required leading bytes (utf8) of every match, used to skip the position which can not start a match without entering the automaton.
+	struct Prefilter
+	{
+		static constexpr std::size_t StartByteCount = 256;
+
+		std::u8string_view Prefix;
+		std::array<std::uint32_t, StartByteCount / 32> StartByte = {};
+
+		void MarkStartByte(char8_t Byte) { StartByte[Byte / 32] |= (std::uint32_t(1) << (Byte % 32)); }
+		bool IsStartByte(char8_t Byte) const { return (StartByte[Byte / 32] & (std::uint32_t(1) << (Byte % 32))) != 0; }
+		std::size_t GetStartByteCount() const;
+		bool IsAvailable() const { return !Prefix.empty() || GetStartByteCount() != StartByteCount; }
+		std::optional<std::size_t> Find(std::span<char8_t const> Str, std::size_t Offset = 0) const;
+	};
+
 	struct Dfa
 	{
 
@@ -284,7 +384,11 @@ export namespace Potato::Reg
 			GreedyHeadMatch,
 		};
 
-		Dfa(FormatE Format, Nfa const& T1);
+		// ThreadCount > 1 expands the states of the same frontier in parallel, ThreadCount 0 means std::thread::hardware_concurrency.
+		// Throw RegexOutOfRange with TypeT::StateCount once the subset construction creates more than MaxStateCount states.
+		// Minimized false keeps the nodes of the subset construction, only for comparing with the minimal table.
+		Dfa(FormatE Format, Nfa const& T1, std::size_t ThreadCount, std::size_t MaxStateCount = std::numeric_limits<std::size_t>::max(), bool Minimized = true);
+		Dfa(FormatE Format, Nfa const& T1) : Dfa(Format, T1, 1) {}
 		Dfa(Dfa&&) = default;
 		Dfa(Dfa const&) = default;
 		Dfa() = default;
@@ -300,8 +404,30 @@ export namespace Potato::Reg
 
 
 		std::size_t GetStartupNodeIndex() const { return 0; }
+		std::size_t GetNodeCount() const { return Nodes.size(); }
 		std::size_t GetCacheCounterCount() const { return CacheRecordCount; }
 		std::size_t GetTempResultCount() const { return ResultCount; }
+		bool IsUnanchored() const { return Unanchored; }
+
+		// Partition the code point space into equivalence classes and build a flat (node x class) -> edge table,
+		// so Consume no longer scans every edge of the current node.
+		void BuildClassTable();
+		bool HasClassTable() const { return Classes.ClassCount != 0; }
+		CharClassTable const& GetClassTable() const { return Classes; }
+
+		Prefilter GetPrefilter() const { return { PrefilterPrefix, PrefilterStartByte }; }
+
+		// True when every edge only records the accept location and jumps without condition, DfaProcessor then skips the property interpreter.
+		bool IsCaptureFree() const { return CaptureFree; }
+
+		// Merge the nodes with the same accept, edges and conditions by partition refinement.
+		// Called at the end of the constructor, so the binary table is always created from the minimal node set.
+		void Minimize();
+
+		// Compile the class table into a byte level UTF-8 automaton, so char8_t/char input can be consumed without decoding.
+		void BuildUtf8Table();
+		bool HasUtf8Table() const { return !Utf8.Empty(); }
+		Utf8ClassTable const& GetUtf8Table() const { return Utf8; }
 	
 	protected:
 
@@ -407,13 +533,27 @@ export namespace Potato::Reg
 			std::optional<AcceptT> Accept;
 		};
 
+		bool ConsumeClass(DfaProcessor& Context, std::size_t Class, std::size_t TokenIndex) const;
+		bool ConsumeEdge(DfaProcessor& Context, EdgeT const& Edge, std::size_t TokenIndex) const;
+		void BuildPrefilter();
+		bool DetectCaptureFree() const;
+
 		FormatE Format;
+		bool Unanchored = false;
+		bool CaptureFree = false;
 		std::size_t CacheRecordCount = 0;
 		std::size_t ResultCount = 0;
 		std::vector<NodeT> Nodes;
+		CharClassTable Classes;
+		std::vector<std::size_t> ClassTransition;
+		Utf8ClassTable Utf8;
+		std::u8string PrefilterPrefix;
+		std::array<std::uint32_t, Prefilter::StartByteCount / 32> PrefilterStartByte = {};
 		
 		friend struct DfaProcessor;
 		friend struct DfaBinaryTableWrapper;
+		friend struct StaticDfaBuilder;
+		friend struct DfaBatchProcessor;
 	};
 
 
@@ -422,14 +562,21 @@ export namespace Potato::Reg
 		using StandardT = uint32_t;
 		using HalfStandardT = uint16_t;
 
+		static constexpr StandardT ContainerTag = 0x41464452;
+		static constexpr StandardT ContainerVersion = 1;
+
+		Dfa::FormatE GetFormat() const { return static_cast<Dfa::FormatE>(reinterpret_cast<HeadT const*>(Wrapper.data())->Format); }
 		std::size_t GetStartupNodeIndex() const { return reinterpret_cast<HeadT const*>(Wrapper.data())->StartupNodeIndex; }
 		std::size_t GetCacheCounterCount() const { return reinterpret_cast<HeadT const*>(Wrapper.data())->CacheSolt; }
 		std::size_t GetTempResultCount() const { return reinterpret_cast<HeadT const*>(Wrapper.data())->TempResult; }
+		bool IsUnanchored() const { return reinterpret_cast<HeadT const*>(Wrapper.data())->Unanchored != 0; }
+		bool IsCaptureFree() const { return reinterpret_cast<HeadT const*>(Wrapper.data())->CaptureFree != 0; }
 
 		struct NodeT
 		{
 			HalfStandardT EdgeCount = 0;
 			HalfStandardT AcceptOffset = 0;
+			StandardT TransitionOffset = 0;
 		};
 
 		struct CharSetPropertyT
@@ -454,11 +601,39 @@ export namespace Potato::Reg
 
 		struct HeadT
 		{
-			Dfa::FormatE Format;
+			StandardT Format = 0;
 			StandardT StartupNodeIndex = 0;
 			StandardT NodeCount = 0;
 			StandardT CacheSolt = 0;
 			StandardT TempResult = 0;
+			StandardT ClassTableOffset = 0;
+			StandardT Utf8TableOffset = 0;
+			StandardT PrefilterOffset = 0;
+			StandardT Unanchored = 0;
+			StandardT CaptureFree = 0;
+		};
+
+		struct CharClassHeadT
+		{
+			StandardT ClassCount = 0;
+			StandardT SparseCount = 0;
+		};
+
+		struct CharClassSparseT
+		{
+			StandardT Start = 0;
+			StandardT Class = 0;
+		};
+
+		struct Utf8HeadT
+		{
+			StandardT StateCount = 0;
+		};
+
+		struct PrefilterT
+		{
+			std::array<StandardT, Prefilter::StartByteCount / 32> StartByte = {};
+			StandardT PrefixSize = 0;
 		};
 
 		struct AcceptT
@@ -472,15 +647,26 @@ export namespace Potato::Reg
 
 		DfaBinaryTableWrapper(std::span<StandardT const> Buffer) : Wrapper(Buffer) {};
 
+		// Buffer is created by CreateDfaBinaryContainer, return nullopt if it fails the BinaryTableContainer::Check.
+		static std::optional<DfaBinaryTableWrapper> FromContainer(std::span<StandardT const> Buffer, bool VerifyChecksum = false);
+
+		bool HasUtf8Table() const { return reinterpret_cast<HeadT const*>(Wrapper.data())->Utf8TableOffset != 0; }
+		Prefilter GetPrefilter() const;
+
 	private:
 
 		bool Consume(DfaProcessor& Context, CodePointT InputValue, std::size_t TokenIndex) const;
+		bool ConsumeClass(DfaProcessor& Context, std::size_t Class, std::size_t TokenIndex) const;
+		bool ConsumeEdge(DfaProcessor& Context, std::size_t EdgeAdress, std::size_t TokenIndex) const;
+		std::size_t LocateClass(CodePointT InputValue) const;
+		std::size_t Utf8Step(std::size_t State, char8_t Byte) const;
 		bool HasAccept(DfaProcessor const& Context) const;
 		ProcessorAcceptRef GetAccept(DfaProcessor const& Context) const;
 
 		std::span<StandardT const> Wrapper;
 
 		friend struct DfaProcessor;
+		friend struct DfaBatchProcessor;
 	};
 
 	template<typename AllocatorT>
@@ -499,6 +685,11 @@ export namespace Potato::Reg
 
 	inline auto CreateDfaBinaryTable(Dfa const& RefTable) { return CreateDfaBinaryTable(RefTable, std::allocator<DfaBinaryTableWrapper::StandardT>{}); }
 
+	inline std::vector<DfaBinaryTableWrapper::StandardT> CreateDfaBinaryContainer(Dfa const& RefTable)
+	{
+		return Misc::BinaryTableContainer::Create(DfaBinaryTableWrapper::ContainerTag, DfaBinaryTableWrapper::ContainerVersion, CreateDfaBinaryTable(RefTable));
+	}
+
 	template<typename CharT, typename CharTraits, typename AllocatorT>
 	auto CreateDfaBinaryTable(Dfa::FormatE Format, std::basic_string_view<CharT, CharTraits> Str, bool IsRaw = false, std::size_t Mask = 0, AllocatorT Allocator = {})
 	{
@@ -517,164 +708,2157 @@ export namespace Potato::Reg
 		return CreateDfaBinaryTable(Dfa{ Format, std::basic_string_view<CharT>{Str}, IsRaw, Mask }, std::allocator<DfaBinaryTableWrapper::StandardT>{});
 	}
 	
-	struct DfaProcessor
+	// Constant evaluated version of CreateDfaBinaryTable for a subset of the syntax of Nfa::BuilderT :
+	// single chars, escapes, '.', char lists, '(?:)', '|', and the greedy or lazy '*', '+', '?'.
+	// Capturing groups and counters are out of the subset, so the result only contains the mask and the main capture.
+	// Build return an empty buffer when the pattern is out of the subset, which makes StaticDfaBinaryTable::Available false.
+	// The tokenizer and the parser below mirror Nfa::BuilderT, a change of the syntax there has to be applied here too.
+	struct StaticDfaBuilder
 	{
+		using StandardT = DfaBinaryTableWrapper::StandardT;
+		static constexpr std::size_t NoNode = std::numeric_limits<std::size_t>::max();
 
-		DfaProcessor(DfaProcessor const&) = default;
-		DfaProcessor(DfaProcessor&&) = default;
-		DfaProcessor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
-			: TempResult(resource), CacheIndex(resource) {}
+		struct RangeT
+		{
+			CodePointT Start;
+			CodePointT End;
+		};
 
-		bool EndOfFile(std::size_t TokenIndex) { return Consume(Reg::EndOfFile(), TokenIndex); }
-		void Clear();
-		bool HasAccept() const;
-		ProcessorAcceptRef GetAccept() const;
-		void SetObserverTable(Dfa const& Table) { TableWrapper = std::reference_wrapper<Dfa const>{Table}; Clear(); }
-		void SetObserverTable(DfaBinaryTableWrapper Table) { TableWrapper = Table; Clear(); }
-		bool Consume(CodePointT Token, std::size_t TokenIndex);
-		bool FragmentProcess(std::span<CodePointT const> input, std::span<std::size_t const> token_index = {});
+		using CharSetT = std::vector<RangeT>;
 
-		template<typename CharT, typename CharTraits>
-		ProcessorAcceptRef Process(std::basic_string_view<CharT, CharTraits> str);
-		template<typename CharT>
-		ProcessorAcceptRef Process(CharT const* str)
+		static constexpr CharSetT Normalize(CharSetT Set);
+		static constexpr CharSetT Union(CharSetT const& T1, CharSetT const& T2);
+		static constexpr CharSetT Subtract(CharSetT const& T1, CharSetT const& T2);
+		static constexpr bool IsInclude(CharSetT const& Set, CodePointT Input);
+		static constexpr CharSetT MaxCharSet() { return { { 1, MaxChar() } }; }
+
+		struct EdgeT
 		{
-			return Process(std::basic_string_view<CharT>(str));
-		}
+			bool Epsilon = true;
+			CharSetT CharSets;
+			std::size_t ToNode = 0;
+		};
+
+		struct NodeT
+		{
+			std::vector<EdgeT> Edges;
+			bool Accept = false;
+		};
+
+		static constexpr std::vector<StandardT> Build(std::span<CodePointT const> Pattern, Dfa::FormatE Format, std::size_t Mask);
 
 	protected:
 
-		std::variant<
-			std::monostate,
-			std::reference_wrapper<Dfa const>,
-			DfaBinaryTableWrapper
-		> TableWrapper;
+		enum class TokenE
+		{
+			SingleChar,
+			CharSet,
+			Min,
+			BracketsLeft,
+			BracketsRight,
+			ParenthesesLeft,
+			ParenthesesRight,
+			CurlyBracketsLeft,
+			CurlyBracketsRight,
+			Num,
+			Comma,
+			Mulity,
+			Question,
+			Or,
+			Add,
+			Not,
+			Colon,
+		};
 
-		std::size_t CurNodeIndex = 0;
-		std::pmr::vector<std::size_t> TempResult;
-		std::pmr::vector<std::size_t> CacheIndex;
-		TokenIndexRecorder Record;
+		struct TokenT
+		{
+			TokenE Type;
+			CharSetT Chars;
+		};
 
-		friend struct Dfa;
-		friend struct DfaBinaryTableWrapper;
+		struct FragmentT
+		{
+			std::size_t In;
+			std::size_t Out;
+		};
+
+		struct ParserT
+		{
+			std::vector<TokenT> Tokens;
+			std::size_t Index = 0;
+			std::vector<NodeT> Nodes;
+
+			constexpr bool IsEnd() const { return Index >= Tokens.size(); }
+			constexpr bool Is(TokenE Type) const { return !IsEnd() && Tokens[Index].Type == Type; }
+			constexpr std::size_t AddNode() { Nodes.push_back({}); return Nodes.size() - 1; }
+			constexpr void AddEdge(std::size_t From, std::size_t To, CharSetT Chars = {}) {
+				bool Epsilon = Chars.empty();
+				Nodes[From].Edges.push_back({ Epsilon, std::move(Chars), To });
+			}
+			constexpr std::optional<FragmentT> ParseStatement();
+			constexpr std::optional<FragmentT> ParseExpression();
+			constexpr std::optional<FragmentT> ParseAtom();
+			constexpr std::optional<CharSetT> ParseCharList();
+		};
+
+		static constexpr std::optional<std::vector<TokenT>> Tokenize(std::span<CodePointT const> Pattern);
+		static constexpr std::optional<std::vector<NodeT>> RemoveEpsilon(std::vector<NodeT> const& Nodes);
+
+		template<typename T>
+		static constexpr std::size_t Push(std::vector<StandardT>& Output, T const& Value)
+		{
+			static_assert(sizeof(T) % sizeof(StandardT) == 0);
+			auto Words = std::bit_cast<std::array<StandardT, sizeof(T) / sizeof(StandardT)>>(Value);
+			auto Adress = Output.size();
+			Output.insert(Output.end(), Words.begin(), Words.end());
+			return Adress;
+		}
+
+		template<typename T>
+		static constexpr T Read(std::vector<StandardT> const& Output, std::size_t Adress)
+		{
+			std::array<StandardT, sizeof(T) / sizeof(StandardT)> Words;
+			std::copy_n(Output.begin() + Adress, Words.size(), Words.begin());
+			return std::bit_cast<T>(Words);
+		}
+
+		template<typename T>
+		static constexpr void Write(std::vector<StandardT>& Output, std::size_t Adress, T const& Value)
+		{
+			auto Words = std::bit_cast<std::array<StandardT, sizeof(T) / sizeof(StandardT)>>(Value);
+			std::copy_n(Words.begin(), Words.size(), Output.begin() + Adress);
+		}
 	};
 
-	template<typename CharT, typename CharTraits>
-	ProcessorAcceptRef DfaProcessor::Process(std::basic_string_view<CharT, CharTraits> str)
+	template<TMP::TypeString Pattern, Dfa::FormatE Format = Dfa::FormatE::HeadMatch, std::size_t Mask = 0>
+	struct StaticDfaBinaryTable
 	{
-		std::array<CodePointT, Encode::Unicode::temporary_cache_buffer_size> temp_buffer;
-		std::array<std::size_t, Encode::Unicode::temporary_cache_buffer_size> source_index;
-		
-		auto ite_str = std::span(str);
-		std::size_t token_index = 0;
+	protected:
 
-		while (!ite_str.empty())
-		{
-			auto info = Encode::UnicodeEncoder<CharT, CodePointT>::EncodeTo(ite_str, temp_buffer, {}, source_index, token_index);
-			auto result = FragmentProcess(
-				std::span(temp_buffer).subspan(0, info.target_space),
-				std::span(source_index).subspan(0, info.target_space)
-				);
+		static constexpr auto CodePoints = []() {
+			constexpr auto Str = TMP::TypeStringEncoder<Pattern, char32_t>::EncodeTo();
+			std::array<CodePointT, Str.Size()> Result{};
+			for (std::size_t I = 0; I < Str.Size(); ++I)
+				Result[I] = static_cast<CodePointT>(Str.string[I]);
+			return Result;
+		}();
 
-			if (!result)
-				return GetAccept();
-			ite_str = ite_str.subspan(info.source_space);
-			token_index += info.source_space;
+		static constexpr std::size_t Size = StaticDfaBuilder::Build(std::span(CodePoints), Format, Mask).size();
+
+	public:
+
+		static constexpr bool Available = (Size != 0);
+
+		static constexpr std::array<DfaBinaryTableWrapper::StandardT, Size> Buffer = []() {
+			std::array<DfaBinaryTableWrapper::StandardT, Size> Result{};
+			auto Temp = StaticDfaBuilder::Build(std::span(CodePoints), Format, Mask);
+			std::copy_n(Temp.begin(), Size, Result.begin());
+			return Result;
+		}();
+	};
+
+	constexpr auto StaticDfaBuilder::Normalize(CharSetT Set) -> CharSetT
+	{
+		std::sort(Set.begin(), Set.end(), [](RangeT const& T1, RangeT const& T2) { return T1.Start < T2.Start; });
+		CharSetT Result;
+		for (auto Ite : Set)
+		{
+			if (Ite.Start >= Ite.End)
+				continue;
+			if (!Result.empty() && Result.rbegin()->End >= Ite.Start)
+				Result.rbegin()->End = std::max(Result.rbegin()->End, Ite.End);
+			else
+				Result.push_back(Ite);
 		}
-		EndOfFile(token_index);
-		return GetAccept();
+		return Result;
 	}
 
-	/*
-	template<typename CharT, typename CharTraidT>
-	ProcessorAcceptRef Process(DfaProcessor& processor, std::basic_string_view<CharT, CharTraidT> str)
+	constexpr auto StaticDfaBuilder::Union(CharSetT const& T1, CharSetT const& T2) -> CharSetT
 	{
-		std::array<CodePointT, Encode::Unicode::temporary_cache_buffer_size> temp_buffer;
-		std::array<std::size_t, Encode::Unicode::temporary_cache_buffer_size> source_index;
+		CharSetT Result = T1;
+		Result.insert(Result.end(), T2.begin(), T2.end());
+		return Normalize(std::move(Result));
+	}
 
-		auto ite_str = std::span(str);
+	constexpr auto StaticDfaBuilder::Subtract(CharSetT const& T1, CharSetT const& T2) -> CharSetT
+	{
+		CharSetT Result;
+		for (auto Ite : T1)
+		{
+			for (auto Ite2 : T2)
+			{
+				if (Ite2.End <= Ite.Start || Ite2.Start >= Ite.End)
+					continue;
+				if (Ite2.Start > Ite.Start)
+					Result.push_back({ Ite.Start, Ite2.Start });
+				Ite.Start = std::max(Ite.Start, Ite2.End);
+				if (Ite.Start >= Ite.End)
+					break;
+			}
+			if (Ite.Start < Ite.End)
+				Result.push_back(Ite);
+		}
+		return Normalize(std::move(Result));
+	}
 
-		bool need_end_of_file = true;
+	constexpr bool StaticDfaBuilder::IsInclude(CharSetT const& Set, CodePointT Input)
+	{
+		for (auto Ite : Set)
+		{
+			if (Input >= Ite.Start && Input < Ite.End)
+				return true;
+		}
+		return false;
+	}
 
-		std::size_t token_index = 0;
+	constexpr auto StaticDfaBuilder::Tokenize(std::span<CodePointT const> Pattern) -> std::optional<std::vector<TokenT>>
+	{
+		std::vector<TokenT> Tokens;
 
-		while (!ite_str.empty() && need_end_of_file)
+		auto Single = [](CodePointT Input) -> CharSetT { return { { Input, Input + 1 } }; };
+
+		for (std::size_t I = 0; I < Pattern.size(); ++I)
 		{
-			auto info = Encode::UnicodeEncoder<CharT, CodePointT>::EncodeTo(ite_str, temp_buffer, std::numeric_limits<std::size_t>::max(), source_index);
-			for(std::size_t index = 0; index < info.target_space; ++index)
+			auto Input = Pattern[I];
+			if (Input >= MaxChar())
+				return std::nullopt;
+			switch (Input)
 			{
-				std::size_t current_token_index = token_index;
-				if (index != 0)
+			case U'-': Tokens.push_back({ TokenE::Min, Single(Input) }); break;
+			case U'[': Tokens.push_back({ TokenE::BracketsLeft, Single(Input) }); break;
+			case U']': Tokens.push_back({ TokenE::BracketsRight, Single(Input) }); break;
+			case U'{': Tokens.push_back({ TokenE::CurlyBracketsLeft, Single(Input) }); break;
+			case U'}': Tokens.push_back({ TokenE::CurlyBracketsRight, Single(Input) }); break;
+			case U',': Tokens.push_back({ TokenE::Comma, Single(Input) }); break;
+			case U'(': Tokens.push_back({ TokenE::ParenthesesLeft, Single(Input) }); break;
+			case U')': Tokens.push_back({ TokenE::ParenthesesRight, Single(Input) }); break;
+			case U'*': Tokens.push_back({ TokenE::Mulity, Single(Input) }); break;
+			case U'?': Tokens.push_back({ TokenE::Question, Single(Input) }); break;
+			case U'.': Tokens.push_back({ TokenE::CharSet, MaxCharSet() }); break;
+			case U'|': Tokens.push_back({ TokenE::Or, Single(Input) }); break;
+			case U'+': Tokens.push_back({ TokenE::Add, Single(Input) }); break;
+			case U'^': Tokens.push_back({ TokenE::Not, Single(Input) }); break;
+			case U':': Tokens.push_back({ TokenE::Colon, Single(Input) }); break;
+			case U'\\':
+			{
+				++I;
+				if (I >= Pattern.size())
+					return std::nullopt;
+				auto Next = Pattern[I];
+				switch (Next)
 				{
-					current_token_index += source_index[index - 1];
-				}
-				auto re = processor.Consume(temp_buffer[index], current_token_index);
-				
-				if (!re)
+				case U'd': Tokens.push_back({ TokenE::CharSet, { { U'0', U'9' + 1 } } }); break;
+				case U'D': Tokens.push_back({ TokenE::CharSet, { { 1, U'0' }, { U'9' + 1, MaxChar() } } }); break;
+				case U'f': Tokens.push_back({ TokenE::SingleChar, Single(U'\f') }); break;
+				case U'n': Tokens.push_back({ TokenE::SingleChar, Single(U'\n') }); break;
+				case U'r': Tokens.push_back({ TokenE::SingleChar, Single(U'\r') }); break;
+				case U't': Tokens.push_back({ TokenE::SingleChar, Single(U'\t') }); break;
+				case U'v': Tokens.push_back({ TokenE::SingleChar, Single(U'\v') }); break;
+				case U's': Tokens.push_back({ TokenE::CharSet, { { 1, 33 }, { 127, 128 } } }); break;
+				case U'S': Tokens.push_back({ TokenE::CharSet, { { 33, 127 }, { 128, MaxChar() } } }); break;
+				case U'w': Tokens.push_back({ TokenE::CharSet, { { U'A', U'Z' + 1 }, { U'_', U'_' + 1 }, { U'a', U'z' + 1 } } }); break;
+				case U'W': Tokens.push_back({ TokenE::CharSet, Subtract(MaxCharSet(), { { U'A', U'Z' + 1 }, { U'_', U'_' + 1 }, { U'a', U'z' + 1 } }) }); break;
+				case U'z': Tokens.push_back({ TokenE::CharSet, { { 256, MaxChar() } } }); break;
+				case U'u':
+				case U'U':
 				{
-					need_end_of_file = false;
+					std::size_t Count = (Next == U'u') ? 4 : 6;
+					CodePointT Number = 0;
+					for (std::size_t I2 = 0; I2 < Count; ++I2)
+					{
+						++I;
+						if (I >= Pattern.size())
+							return std::nullopt;
+						auto Hex = Pattern[I];
+						if (Hex >= U'0' && Hex <= U'9')
+							Number = Number * 16 + (Hex - U'0');
+						else if (Hex >= U'a' && Hex <= U'f')
+							Number = Number * 16 + (Hex - U'a' + 10);
+						else if (Hex >= U'A' && Hex <= U'F')
+							Number = Number * 16 + (Hex - U'A' + 10);
+						else
+							return std::nullopt;
+					}
+					Tokens.push_back({ TokenE::SingleChar, Single(Number) });
+					break;
+				}
+				default:
+					Tokens.push_back({ TokenE::SingleChar, Single(Next) });
 					break;
 				}
+				break;
+			}
+			default:
+				if (Input >= U'0' && Input <= U'9')
+					Tokens.push_back({ TokenE::Num, Single(Input) });
+				else
+					Tokens.push_back({ TokenE::SingleChar, Single(Input) });
+				break;
 			}
-			ite_str = ite_str.subspan(info.source_space);
-			token_index += info.source_space;
 		}
-
-		if (need_end_of_file)
-			processor.EndOfFile(token_index);
-
-		return processor.GetAccept();
+		return Tokens;
 	}
 
-	template<typename ProcessorT, typename CharT>
-	ProcessorAcceptRef Process(ProcessorT& Pro, CharT const* Str)
+	constexpr auto StaticDfaBuilder::ParserT::ParseStatement() -> std::optional<FragmentT>
 	{
-		return Process(Pro, std::basic_string_view<CharT>(Str));
-	}
+		auto Last = ParseExpression();
+		if (!Last.has_value())
+			return std::nullopt;
 
-	template<typename CharT, typename CharTrais, typename Func>
-	void Process(Dfa const& Table, std::basic_string_view<CharT, CharTrais> Str, Func&& Fun)
-	{
-		DfaProcessor Processor;
-		Processor.SetObserverTable(Table);
-		Fun(Process(Processor, Str));
+		while (!IsEnd() && !Is(TokenE::Or) && !Is(TokenE::ParenthesesRight))
+		{
+			auto Next = ParseExpression();
+			if (!Next.has_value())
+				return std::nullopt;
+			AddEdge(Last->Out, Next->In);
+			Last = FragmentT{ Last->In, Next->Out };
+		}
+
+		while (Is(TokenE::Or))
+		{
+			++Index;
+			auto Last2 = ParseExpression();
+			if (!Last2.has_value())
+				return std::nullopt;
+			while (!IsEnd() && !Is(TokenE::Or) && !Is(TokenE::ParenthesesRight))
+			{
+				auto Next = ParseExpression();
+				if (!Next.has_value())
+					return std::nullopt;
+				AddEdge(Last2->Out, Next->In);
+				Last2 = FragmentT{ Last2->In, Next->Out };
+			}
+			auto T1 = AddNode();
+			auto T2 = AddNode();
+			AddEdge(T1, Last->In);
+			AddEdge(T1, Last2->In);
+			AddEdge(Last->Out, T2);
+			AddEdge(Last2->Out, T2);
+			Last = FragmentT{ T1, T2 };
+		}
+
+		return Last;
 	}
 
-	template<typename CharT, typename Func>
-	void Process(Dfa const& Table, CharT const* Str, Func&& Fun)
+	constexpr auto StaticDfaBuilder::ParserT::ParseExpression() -> std::optional<FragmentT>
 	{
-		Process(Table, std::basic_string_view<CharT>(Str), std::forward<Func>(Fun));
+		auto Last1 = ParseAtom();
+		if (!Last1.has_value())
+			return std::nullopt;
+
+		if (Is(TokenE::CurlyBracketsLeft))
+			return std::nullopt;
+
+		bool Star = Is(TokenE::Mulity);
+		bool Plus = Is(TokenE::Add);
+		bool Optional = Is(TokenE::Question);
+
+		if (!Star && !Plus && !Optional)
+			return Last1;
+
+		++Index;
+		bool Lazy = false;
+		if (Is(TokenE::Question))
+		{
+			++Index;
+			Lazy = true;
+		}
+
+		// chained quantifier follows the precedence of the lr table, leave it to the runtime builder
+		if (Is(TokenE::Mulity) || Is(TokenE::Add) || Is(TokenE::Question) || Is(TokenE::CurlyBracketsLeft))
+			return std::nullopt;
+
+		auto T1 = AddNode();
+		auto T2 = AddNode();
+
+		if (Star && !Lazy)
+		{
+			AddEdge(T1, Last1->In);
+			AddEdge(T1, T2);
+			AddEdge(Last1->Out, Last1->In);
+			AddEdge(Last1->Out, T2);
+		}
+		else if (Plus && !Lazy)
+		{
+			AddEdge(T1, Last1->In);
+			AddEdge(Last1->Out, Last1->In);
+			AddEdge(Last1->Out, T2);
+		}
+		else if (Star)
+		{
+			AddEdge(T1, T2);
+			AddEdge(T1, Last1->In);
+			AddEdge(Last1->Out, T2);
+			AddEdge(Last1->Out, Last1->In);
+		}
+		else if (Plus)
+		{
+			AddEdge(T1, Last1->In);
+			AddEdge(Last1->Out, T2);
+			AddEdge(Last1->Out, Last1->In);
+		}
+		else if (!Lazy)
+		{
+			AddEdge(T1, Last1->In);
+			AddEdge(Last1->Out, T2);
+			AddEdge(T1, T2);
+		}
+		else {
+			AddEdge(T1, T2);
+			AddEdge(T1, Last1->In);
+			AddEdge(Last1->Out, T2);
+		}
+		return FragmentT{ T1, T2 };
 	}
-	*/
 
-	struct MulityRegCreater
+	constexpr auto StaticDfaBuilder::ParserT::ParseAtom() -> std::optional<FragmentT>
 	{
-		template<typename CharT, typename CharTraits>
-		void AppendReg(std::basic_string_view<CharT, CharTraits> Str, bool IsRaw, std::size_t Mask)
+		if (IsEnd())
+			return std::nullopt;
+
+		auto& Cur = Tokens[Index];
+
+		switch (Cur.Type)
+		{
+		case TokenE::SingleChar:
+		case TokenE::Num:
+		case TokenE::Min:
+		case TokenE::Comma:
+		case TokenE::Colon:
+		case TokenE::CharSet:
 		{
-			if (Table.has_value())
+			++Index;
+			auto T1 = AddNode();
+			auto T2 = AddNode();
+			AddEdge(T1, T2, Tokens[Index - 1].Chars);
+			return FragmentT{ T1, T2 };
+		}
+		case TokenE::BracketsLeft:
+		{
+			++Index;
+			bool IsNot = false;
+			if (Is(TokenE::Not))
 			{
-				Table->Link(Nfa{Str, IsRaw, Mask});
-			}
-			else {
-				Table.emplace(Str, IsRaw, Mask);
+				++Index;
+				IsNot = true;
 			}
+			auto Chars = ParseCharList();
+			if (!Chars.has_value() || !Is(TokenE::BracketsRight))
+				return std::nullopt;
+			++Index;
+			if (IsNot)
+				Chars = Subtract(MaxCharSet(), *Chars);
+			if (Chars->empty())
+				return std::nullopt;
+			auto T1 = AddNode();
+			auto T2 = AddNode();
+			AddEdge(T1, T2, std::move(*Chars));
+			return FragmentT{ T1, T2 };
 		}
-
-		template<typename CharT>
-		void AppendReg(CharT const* Str, bool IsRaw, std::size_t Mask)
+		case TokenE::ParenthesesLeft:
 		{
-			return AppendReg(std::basic_string_view<CharT>(Str), IsRaw, Mask);
+			++Index;
+			// a capture can not be reported by the static table, so only the non-capturing group is accepted
+			if (!Is(TokenE::Question))
+				return std::nullopt;
+			++Index;
+			if (!Is(TokenE::Colon))
+				return std::nullopt;
+			++Index;
+			auto Inside = ParseStatement();
+			if (!Inside.has_value() || !Is(TokenE::ParenthesesRight))
+				return std::nullopt;
+			++Index;
+			return Inside;
+		}
+		default:
+			return std::nullopt;
 		}
+	}
 
-		std::optional<Dfa> CreateDfa(Dfa::FormatE Format) const { if (Table.has_value())  return Dfa{ Format, *Table }; return {}; }
+	constexpr auto StaticDfaBuilder::ParserT::ParseCharList() -> std::optional<CharSetT>
+	{
+		auto IsSingle = [this]() {
+			return Is(TokenE::SingleChar) || Is(TokenE::Num) || Is(TokenE::Comma) || Is(TokenE::Colon);
+		};
 
-		template<typename AllocatorT = std::allocator<DfaBinaryTableWrapper::StandardT>>
-		std::optional<std::vector<DfaBinaryTableWrapper::StandardT>> CreateDfaBinary(Dfa::FormatE Format, AllocatorT Allocator = {}) const { if (Table.has_value())  return CreateDfaBinaryTable(Dfa{Format, *Table}, std::move(Allocator)); return {}; }
-	
-	protected:
-		std::optional<Nfa> Table;
-	};
+		CharSetT Result;
+		bool Empty = true;
+
+		if (Is(TokenE::Min))
+		{
+			Result = Union(Result, Tokens[Index].Chars);
+			++Index;
+			Empty = false;
+		}
+
+		while (!IsEnd() && !Is(TokenE::BracketsRight))
+		{
+			if (IsSingle())
+			{
+				auto Start = Tokens[Index].Chars[0].Start;
+				++Index;
+				if (Is(TokenE::Min) && Index + 1 < Tokens.size() && Tokens[Index + 1].Type != TokenE::BracketsRight)
+				{
+					++Index;
+					if (!IsSingle())
+						return std::nullopt;
+					auto End = Tokens[Index].Chars[0].Start;
+					++Index;
+					Result = Union(Result, { { std::min(Start, End), std::max(Start, End) + 1 } });
+				}
+				else
+					Result = Union(Result, { { Start, Start + 1 } });
+			}
+			else if (Is(TokenE::CharSet))
+			{
+				Result = Union(Result, Tokens[Index].Chars);
+				++Index;
+			}
+			else if (Is(TokenE::Min) && !Empty && Index + 1 < Tokens.size() && Tokens[Index + 1].Type == TokenE::BracketsRight)
+			{
+				Result = Union(Result, Tokens[Index].Chars);
+				++Index;
+			}
+			else
+				return std::nullopt;
+			Empty = false;
+		}
+
+		if (Empty)
+			return std::nullopt;
+		return Result;
+	}
+
+	constexpr auto StaticDfaBuilder::RemoveEpsilon(std::vector<NodeT> const& Nodes) -> std::optional<std::vector<NodeT>>
+	{
+		std::vector<NodeT> Result;
+		std::vector<std::size_t> Mapping(Nodes.size(), NoNode);
+		std::vector<std::size_t> SearchingStack;
+
+		Mapping[0] = 0;
+		Result.push_back({});
+		SearchingStack.push_back(0);
+
+		std::vector<std::size_t> StateStack;
+		bool Fail = false;
+
+		auto Collect = [&](auto& Self, std::size_t Target, std::size_t Current) -> void {
+			for (auto& Ite : Nodes[Current].Edges)
+			{
+				if (Fail)
+					return;
+				if (Ite.Epsilon)
+				{
+					if (std::find(StateStack.begin(), StateStack.end(), Ite.ToNode) != StateStack.end())
+					{
+						Fail = true;
+						return;
+					}
+					StateStack.push_back(Ite.ToNode);
+					Self(Self, Target, Ite.ToNode);
+					StateStack.pop_back();
+				}
+				else {
+					if (Mapping[Ite.ToNode] == NoNode)
+					{
+						Mapping[Ite.ToNode] = Result.size();
+						Result.push_back({ {}, Nodes[Ite.ToNode].Accept });
+						SearchingStack.push_back(Ite.ToNode);
+					}
+					auto ToNode = Mapping[Ite.ToNode];
+					for (auto& Ite2 : Result[Target].Edges)
+					{
+						if (Ite2.ToNode == ToNode)
+						{
+							Fail = true;
+							return;
+						}
+					}
+					Result[Target].Edges.push_back({ false, Ite.CharSets, ToNode });
+				}
+			}
+		};
+
+		while (!SearchingStack.empty() && !Fail)
+		{
+			auto Top = *SearchingStack.rbegin();
+			SearchingStack.pop_back();
+			StateStack.clear();
+			StateStack.push_back(Top);
+			Collect(Collect, Mapping[Top], Top);
+		}
+
+		if (Fail)
+			return std::nullopt;
+
+		auto IsSameEdge = [](EdgeT const& T1, EdgeT const& T2) {
+			if (T1.ToNode != T2.ToNode || T1.CharSets.size() != T2.CharSets.size())
+				return false;
+			for (std::size_t I = 0; I < T1.CharSets.size(); ++I)
+			{
+				if (T1.CharSets[I].Start != T2.CharSets[I].Start || T1.CharSets[I].End != T2.CharSets[I].End)
+					return false;
+			}
+			return true;
+		};
+
+		bool Change = true;
+		while (Change)
+		{
+			Change = false;
+			for (std::size_t I1 = 1; I1 < Result.size(); ++I1)
+			{
+				for (std::size_t I2 = I1 + 1; I2 < Result.size(); )
+				{
+					auto& N1 = Result[I1];
+					auto& N2 = Result[I2];
+					bool Same = N1.Accept == N2.Accept && N1.Edges.size() == N2.Edges.size();
+					for (std::size_t I = 0; Same && I < N1.Edges.size(); ++I)
+						Same = IsSameEdge(N1.Edges[I], N2.Edges[I]);
+					if (Same)
+					{
+						for (auto& Ite3 : Result)
+						{
+							for (auto& Ite4 : Ite3.Edges)
+							{
+								if (Ite4.ToNode == I2)
+									Ite4.ToNode = I1;
+								else if (Ite4.ToNode > I2)
+									--Ite4.ToNode;
+							}
+						}
+						Result.erase(Result.begin() + I2);
+						Change = true;
+					}
+					else
+						++I2;
+				}
+			}
+		}
+
+		return Result;
+	}
+
+	constexpr auto StaticDfaBuilder::Build(std::span<CodePointT const> Pattern, Dfa::FormatE Format, std::size_t Mask) -> std::vector<StandardT>
+	{
+		auto Tokens = Tokenize(Pattern);
+		if (!Tokens.has_value())
+			return {};
+
+		ParserT Parser{ std::move(*Tokens) };
+		auto Top = Parser.AddNode();
+		auto Re = Parser.ParseStatement();
+		if (!Re.has_value() || !Parser.IsEnd())
+			return {};
+
+		Parser.AddEdge(Top, Re->In);
+		auto Last = Parser.AddNode();
+		Parser.AddEdge(Re->Out, Last, { { EndOfFile(), EndOfFile() + 1 } });
+		Parser.Nodes[Last].Accept = true;
+
+		auto Nodes = RemoveEpsilon(Parser.Nodes);
+		if (!Nodes.has_value())
+			return {};
+
+		std::vector<CodePointT> Bounds;
+		Bounds.push_back(0);
+		Bounds.push_back(1);
+		Bounds.push_back(MaxChar());
+		for (auto& Ite : *Nodes)
+		{
+			for (auto& Ite2 : Ite.Edges)
+			{
+				for (auto Ite3 : Ite2.CharSets)
+				{
+					Bounds.push_back(std::min(Ite3.Start, MaxChar()));
+					Bounds.push_back(std::min(Ite3.End, MaxChar()));
+				}
+			}
+		}
+		std::sort(Bounds.begin(), Bounds.end());
+		Bounds.erase(std::unique(Bounds.begin(), Bounds.end()), Bounds.end());
+
+		struct TransitionT
+		{
+			std::size_t ToState = NoNode;
+			bool RecordAccept = false;
+		};
+
+		struct StateT
+		{
+			std::vector<std::size_t> Threads;
+			std::vector<TransitionT> Transitions;
+			bool Accept = false;
+			bool HasEdge = false;
+		};
+
+		std::vector<StateT> States;
+
+		auto InsertState = [&](std::vector<std::size_t> Threads) -> std::size_t {
+			for (std::size_t I = 0; I < States.size(); ++I)
+			{
+				if (States[I].Threads == Threads)
+					return I;
+			}
+			StateT NewState;
+			for (auto Ite : Threads)
+			{
+				if ((*Nodes)[Ite].Accept)
+					NewState.Accept = true;
+				if (!(*Nodes)[Ite].Edges.empty())
+					NewState.HasEdge = true;
+			}
+			NewState.Threads = std::move(Threads);
+			States.push_back(std::move(NewState));
+			return States.size() - 1;
+		};
+
+		InsertState({ 0 });
+
+		// same thread semantic as Dfa, an accepted thread stops the threads with lower priority
+		for (std::size_t StateIndex = 0; StateIndex < States.size(); ++StateIndex)
+		{
+			for (std::size_t Seg = 0; Seg + 1 < Bounds.size(); ++Seg)
+			{
+				auto Input = Bounds[Seg];
+				auto Threads = States[StateIndex].Threads;
+				std::vector<std::size_t> NextThreads;
+				std::size_t StickyAccept = NoNode;
+				bool RecordAccept = false;
+				bool Stop = false;
+
+				for (auto Ite : Threads)
+				{
+					if (Stop)
+						break;
+					auto& NodeRef = (*Nodes)[Ite];
+					if (StickyAccept == NoNode && NodeRef.Accept)
+						StickyAccept = Ite;
+					for (auto& Ite2 : NodeRef.Edges)
+					{
+						bool ToAccept = (*Nodes)[Ite2.ToNode].Accept;
+						if (!(ToAccept && Format != Dfa::FormatE::Match) && !IsInclude(Ite2.CharSets, Input))
+							continue;
+						if (std::find(NextThreads.begin(), NextThreads.end(), Ite2.ToNode) != NextThreads.end())
+							return {};
+						NextThreads.push_back(Ite2.ToNode);
+						if (ToAccept)
+						{
+							RecordAccept = true;
+							Stop = true;
+							break;
+						}
+					}
+				}
+
+				TransitionT Transition;
+
+				if (!NextThreads.empty())
+				{
+					if (StickyAccept != NoNode && Format != Dfa::FormatE::Match)
+					{
+						bool ExistAccept = false;
+						for (auto Ite : NextThreads)
+							ExistAccept = ExistAccept || (*Nodes)[Ite].Accept;
+						if (!ExistAccept)
+							NextThreads.push_back(StickyAccept);
+					}
+					Transition.ToState = InsertState(std::move(NextThreads));
+					Transition.RecordAccept = RecordAccept;
+				}
+
+				States[StateIndex].Transitions.push_back(Transition);
+			}
+		}
+
+		using WrapperT = DfaBinaryTableWrapper;
+
+		std::vector<StandardT> Output;
+		std::vector<std::size_t> NodeAdress;
+
+		struct ConditionReferenceT
+		{
+			std::size_t Adress;
+			std::size_t ToState;
+		};
+
+		std::vector<ConditionReferenceT> ConditionReference;
+
+		Push(Output, WrapperT::HeadT{});
+
+		for (auto& Ite : States)
+		{
+			struct GroupT
+			{
+				TransitionT Transition;
+				CharSetT CharSets;
+			};
+
+			std::vector<GroupT> Groups;
+
+			for (std::size_t Seg = 0; Seg < Ite.Transitions.size(); ++Seg)
+			{
+				auto Tran = Ite.Transitions[Seg];
+				if (Tran.ToState == NoNode)
+					continue;
+				bool Find = false;
+				for (auto& Ite2 : Groups)
+				{
+					if (Ite2.Transition.ToState == Tran.ToState && Ite2.Transition.RecordAccept == Tran.RecordAccept)
+					{
+						Ite2.CharSets = Union(Ite2.CharSets, { { Bounds[Seg], Bounds[Seg + 1] } });
+						Find = true;
+						break;
+					}
+				}
+				if (!Find)
+					Groups.push_back({ Tran, { { Bounds[Seg], Bounds[Seg + 1] } } });
+			}
+
+			WrapperT::NodeT NewNode;
+			NewNode.EdgeCount = static_cast<WrapperT::HalfStandardT>(Groups.size());
+			auto Adress = Push(Output, NewNode);
+			NodeAdress.push_back(Adress);
+
+			std::vector<std::size_t> CharSetAdress;
+
+			for (auto& Ite2 : Groups)
+			{
+				WrapperT::CharSetPropertyT Property;
+				Property.CharCount = static_cast<WrapperT::HalfStandardT>(Ite2.CharSets.size());
+				CharSetAdress.push_back(Push(Output, Property));
+				for (auto Ite3 : Ite2.CharSets)
+				{
+					Push(Output, Interval::ElementT{ Ite3.Start, Ite3.End });
+				}
+			}
+
+			for (std::size_t I = 0; I < Groups.size(); ++I)
+			{
+				auto& Ite2 = Groups[I];
+				WrapperT::EdgeT NewEdge;
+				NewEdge.PropertyCount = Ite2.Transition.RecordAccept ? 1 : 0;
+				NewEdge.ConditionCount = 1;
+				auto EdgeAdress = Push(Output, NewEdge);
+
+				auto Property = Read<WrapperT::CharSetPropertyT>(Output, CharSetAdress[I]);
+				Property.EdgeOffset = static_cast<WrapperT::HalfStandardT>(EdgeAdress - Adress);
+				Write(Output, CharSetAdress[I], Property);
+
+				if (Ite2.Transition.RecordAccept)
+					Output.push_back(static_cast<StandardT>(Dfa::PropertyActioE::RecordAcceptLocation));
+
+				WrapperT::ConditionT Condition;
+				Condition.PassCommand = static_cast<WrapperT::HalfStandardT>(
+					States[Ite2.Transition.ToState].HasEdge ? Dfa::ConditionT::CommandE::ToNode : Dfa::ConditionT::CommandE::ToAcceptNode
+				);
+				Condition.UnpassCommand = static_cast<WrapperT::HalfStandardT>(Dfa::ConditionT::CommandE::Fail);
+				ConditionReference.push_back({ Push(Output, Condition), Ite2.Transition.ToState });
+			}
+
+			if (Ite.Accept)
+			{
+				WrapperT::AcceptT NewAccept;
+				NewAccept.Mask = static_cast<StandardT>(Mask);
+				auto AcceptAdress = Push(Output, NewAccept);
+				NewNode.AcceptOffset = static_cast<WrapperT::HalfStandardT>(AcceptAdress - Adress);
+				Write(Output, Adress, NewNode);
+			}
+		}
+
+		for (auto& Ite : ConditionReference)
+		{
+			auto Condition = Read<WrapperT::ConditionT>(Output, Ite.Adress);
+			Condition.Pass = static_cast<StandardT>(NodeAdress[Ite.ToState]);
+			Write(Output, Ite.Adress, Condition);
+		}
+
+		WrapperT::HeadT Head;
+		Head.Format = static_cast<StandardT>(Format);
+		Head.StartupNodeIndex = static_cast<StandardT>(NodeAdress[0]);
+		Head.NodeCount = static_cast<StandardT>(NodeAdress.size());
+		Head.TempResult = 1;
+		Head.CaptureFree = 1;
+		Write(Output, 0, Head);
+
+		return Output;
+	}
+
+	// Create the Dfa state on demand while matching, only the states reached by the input are built.
+	// Sub captures are not tracked, the processor only reports the mask and the main capture.
+	// The cache is cleared when it reaches MaxStateCount, so it can only be observed by one DfaProcessor at a time.
+	struct LazyDfa
+	{
+		LazyDfa(Dfa::FormatE Format, Nfa const& T1, std::size_t MaxStateCount = 1024);
+		LazyDfa(LazyDfa&&) = default;
+		LazyDfa(LazyDfa const&) = default;
+
+		template<typename CharT, typename CharTraisT>
+		LazyDfa(Dfa::FormatE Format, std::basic_string_view<CharT, CharTraisT> Str, bool IsRaw = false, std::size_t Mask = 0, std::size_t MaxStateCount = 1024)
+			: LazyDfa(Format, Nfa{ Str, IsRaw, Mask }, MaxStateCount) {}
+
+		template<typename CharT>
+		LazyDfa(Dfa::FormatE Format, CharT const* Str, bool IsRaw = false, std::size_t Mask = 0, std::size_t MaxStateCount = 1024)
+			: LazyDfa(Format, std::basic_string_view{ Str }, IsRaw, Mask, MaxStateCount) {}
+
+		std::size_t GetStartupNodeIndex() const { return 0; }
+		std::size_t GetStateCount() const { return States.size(); }
+		std::size_t GetMaxStateCount() const { return MaxStateCount; }
+		std::size_t GetClearCount() const { return ClearCount; }
+		CharClassTable const& GetClassTable() const { return Classes; }
+		void ClearCache();
+
+	protected:
+
+		static constexpr std::size_t UnknownTransition = std::numeric_limits<std::size_t>::max();
+		static constexpr std::size_t DeadTransition = UnknownTransition - 1;
+
+		struct StateT
+		{
+			std::vector<std::size_t> Threads;
+			std::optional<std::size_t> Mask;
+			bool HasEdge = false;
+		};
+
+		bool Consume(DfaProcessor& Context, CodePointT InputValue, std::size_t TokenIndex);
+		bool HasAccept(DfaProcessor const& Context) const;
+		ProcessorAcceptRef GetAccept(DfaProcessor const& Context) const;
+		std::size_t InsertState(std::vector<std::size_t> Threads);
+		std::size_t Step(std::size_t& StateIndex, std::size_t Class);
+
+		Dfa::FormatE Format;
+		std::vector<Nfa::NodeT> Nodes;
+		std::size_t MaxStateCount = 0;
+		std::size_t ClearCount = 0;
+		std::map<std::tuple<std::size_t, std::size_t>, std::size_t> CounterSolt;
+		std::vector<std::size_t> CounterLimit;
+		CharClassTable Classes;
+		std::vector<CodePointT> ClassRepresent;
+		std::vector<std::size_t> StartupThreads;
+		std::map<std::vector<std::size_t>, std::size_t> Mapping;
+		std::vector<StateT> States;
+		std::vector<std::size_t> Transition;
+
+		friend struct DfaProcessor;
+	};
+
+	// Build the Dfa if it fits in MaxStateCount states, otherwise fall back to the LazyDfa, which simulates the Nfa
+	// with a bounded state cache, so a pattern with a huge state space can not stall the construction.
+	// The LazyDfa only reports the mask and the main capture.
+	std::variant<Dfa, LazyDfa> CreateHybridDfa(Dfa::FormatE Format, Nfa const& T1, std::size_t MaxStateCount = 4096, std::size_t MaxLazyStateCount = 1024);
+
+	// Bit-parallel simulation of a small Nfa, every edge is a position and the state is a 64 bit position set.
+	// Only the Match format is supported, the captures are ignored and the Nfa can not contain counters.
+	struct BitParallelNfa
+	{
+		static constexpr std::size_t MaxPositionCount = 63;
+
+		static bool IsAvailable(Nfa const& T1);
+
+		BitParallelNfa(Nfa const& T1);
+		BitParallelNfa(BitParallelNfa&&) = default;
+		BitParallelNfa(BitParallelNfa const&) = default;
+
+		template<typename CharT, typename CharTraisT>
+		BitParallelNfa(std::basic_string_view<CharT, CharTraisT> Str, bool IsRaw = false, std::size_t Mask = 0)
+			: BitParallelNfa(Nfa{ Str, IsRaw, Mask }) {}
+
+		template<typename CharT>
+		BitParallelNfa(CharT const* Str, bool IsRaw = false, std::size_t Mask = 0)
+			: BitParallelNfa(std::basic_string_view{ Str }, IsRaw, Mask) {}
+
+		std::uint64_t GetStartupState() const { return 1; }
+		std::size_t GetPositionCount() const { return PositionCount; }
+		CharClassTable const& GetClassTable() const { return Classes; }
+
+	protected:
+
+		static constexpr std::size_t ChunkBits = 8;
+		static constexpr std::size_t ChunkSize = std::size_t(1) << ChunkBits;
+
+		struct AcceptT
+		{
+			std::size_t Mask = 0;
+			std::size_t MaskIndex = 0;
+		};
+
+		std::uint64_t Follow(std::uint64_t State) const;
+		bool Consume(DfaProcessor& Context, CodePointT InputValue, std::size_t TokenIndex) const;
+		bool HasAccept(DfaProcessor const& Context) const;
+		ProcessorAcceptRef GetAccept(DfaProcessor const& Context) const;
+
+		std::size_t PositionCount = 0;
+		CharClassTable Classes;
+		std::vector<std::uint64_t> ClassPositions;
+		// FollowChunk[Chunk * ChunkSize + Bits] is the union of the follow set of the positions in Bits.
+		std::vector<std::uint64_t> FollowChunk;
+		std::uint64_t AcceptPositions = 0;
+		std::uint64_t EdgePositions = 0;
+		std::vector<AcceptT> Accepts;
+
+		friend struct DfaProcessor;
+	};
+
+	// Dfa of the reversed patterns, consumed from the end of a match towards its begin, so a search only has to
+	// find the match end with a capture free forward table. The captures are ignored and the Nfa can not contain counters.
+	// For an unanchored Nfa, the implicit '.*?' is skipped.
+	struct ReverseDfa
+	{
+		static bool IsAvailable(Nfa const& T1);
+
+		ReverseDfa(Nfa const& T1);
+		ReverseDfa(ReverseDfa&&) = default;
+		ReverseDfa(ReverseDfa const&) = default;
+		ReverseDfa() = default;
+		ReverseDfa& operator=(ReverseDfa&&) = default;
+
+		template<typename CharT, typename CharTraisT>
+		ReverseDfa(std::basic_string_view<CharT, CharTraisT> Str, bool IsRaw = false, std::size_t Mask = 0)
+			: ReverseDfa(Nfa{ Str, IsRaw, Mask }) {}
+
+		template<typename CharT>
+		ReverseDfa(CharT const* Str, bool IsRaw = false, std::size_t Mask = 0)
+			: ReverseDfa(std::basic_string_view{ Str }, IsRaw, Mask) {}
+
+		static constexpr std::size_t DeadState = 0;
+
+		std::size_t GetStateCount() const { return Accepts.size(); }
+		CharClassTable const& GetClassTable() const { return Classes; }
+		std::size_t GetStartupState(std::size_t Mask) const;
+		bool IsAccept(std::size_t State) const { return Accepts[State]; }
+		std::size_t Step(std::size_t State, CodePointT InputValue) const { return Transition[State * Classes.ClassCount + Classes.Locate(InputValue)]; }
+
+		// Return the smallest Begin >= MinBegin which Str[Begin, End) is a match of the pattern with Mask.
+		template<typename CharT, typename CharTraits>
+		std::optional<std::size_t> FindStart(std::basic_string_view<CharT, CharTraits> Str, std::size_t Mask, std::size_t End, std::size_t MinBegin = 0) const;
+
+	protected:
+
+		struct StartupT
+		{
+			std::size_t Mask;
+			std::size_t State;
+		};
+
+		CharClassTable Classes;
+		std::vector<std::size_t> Transition;
+		std::vector<bool> Accepts;
+		std::vector<StartupT> Startups;
+	};
+
+	template<typename CharT, typename CharTraits>
+	std::optional<std::size_t> ReverseDfa::FindStart(std::basic_string_view<CharT, CharTraits> Str, std::size_t Mask, std::size_t End, std::size_t MinBegin) const
+	{
+		assert(MinBegin <= End && End <= Str.size());
+
+		auto State = GetStartupState(Mask);
+		if (State == DeadState)
+			return std::nullopt;
+
+		std::optional<std::size_t> Begin;
+		if (IsAccept(State))
+			Begin = End;
+
+		auto Ite = End;
+		while (Ite > MinBegin)
+		{
+			auto Last = Ite - 1;
+			if constexpr (sizeof(CharT) == sizeof(char8_t))
+			{
+				while (Last > MinBegin && (static_cast<std::uint8_t>(Str[Last]) & 0xC0) == 0x80)
+					--Last;
+			}
+			else if constexpr (sizeof(CharT) == sizeof(char16_t))
+			{
+				if (Last > MinBegin && (static_cast<std::uint16_t>(Str[Last]) & 0xFC00) == 0xDC00 && (static_cast<std::uint16_t>(Str[Last - 1]) & 0xFC00) == 0xD800)
+					--Last;
+			}
+
+			CodePointT Value = 0;
+			Encode::EncodeCutOffSetting Cutoff;
+			Cutoff.max_character_count = 1;
+			auto Info = Encode::UnicodeEncoder<CharT, CodePointT>::EncodeTo(std::span(Str).subspan(Last, Ite - Last), std::span(&Value, 1), Cutoff);
+			if (Info.target_space == 0)
+				break;
+
+			State = Step(State, Value);
+			if (State == DeadState)
+				break;
+			Ite = Last;
+			if (IsAccept(State))
+				Begin = Ite;
+		}
+		return Begin;
+	}
+
+	struct DfaProcessor
+	{
+
+		DfaProcessor(DfaProcessor const&) = default;
+		DfaProcessor(DfaProcessor&&) = default;
+		DfaProcessor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: TempResult(resource), CacheIndex(resource) {}
+
+		bool EndOfFile(std::size_t TokenIndex) { return Consume(Reg::EndOfFile(), TokenIndex); }
+		void Clear();
+		bool HasAccept() const;
+		ProcessorAcceptRef GetAccept() const;
+		void SetObserverTable(Dfa const& Table) { TableWrapper = std::reference_wrapper<Dfa const>{Table}; Clear(); }
+		void SetObserverTable(DfaBinaryTableWrapper Table) { TableWrapper = Table; Clear(); }
+		void SetObserverTable(LazyDfa& Table) { TableWrapper = std::reference_wrapper<LazyDfa>{Table}; Clear(); }
+		void SetObserverTable(BitParallelNfa const& Table) { TableWrapper = std::reference_wrapper<BitParallelNfa const>{Table}; Clear(); }
+		void SetObserverTable(std::variant<BitParallelNfa, Dfa> const& Table) { std::visit([this](auto const& Ref) { SetObserverTable(Ref); }, Table); }
+		void SetObserverTable(std::variant<Dfa, LazyDfa>& Table) { std::visit([this](auto& Ref) { SetObserverTable(Ref); }, Table); }
+		bool Consume(CodePointT Token, std::size_t TokenIndex);
+		bool FragmentProcess(std::span<CodePointT const> input, std::span<std::size_t const> token_index = {});
+
+		// Only available when the observed table has an utf8 table, ByteIndex is the offset of the byte in the source string.
+		bool HasUtf8Table() const;
+		bool ConsumeByte(char8_t Byte, std::size_t ByteIndex);
+		bool FragmentProcess(std::span<char8_t const> input, std::size_t start_byte_index = 0);
+
+		Prefilter GetPrefilter() const;
+
+		// start matching at str[offset], the token index in result is still relative to str.
+		template<typename CharT, typename CharTraits>
+		ProcessorAcceptRef Process(std::basic_string_view<CharT, CharTraits> str, std::size_t offset = 0);
+		template<typename CharT>
+		ProcessorAcceptRef Process(CharT const* str, std::size_t offset = 0)
+		{
+			return Process(std::basic_string_view<CharT>(str), offset);
+		}
+
+		// Only for the table created from an unanchored Nfa, return the leftmost match from offset with a single pass.
+		// MainCapture is the location of the match, the implicit capture is removed from the result.
+		bool IsUnanchored() const;
+		bool IsCaptureFree() const;
+		template<typename CharT, typename CharTraits>
+		ProcessorAcceptRef Search(std::basic_string_view<CharT, CharTraits> str, std::size_t offset = 0);
+		template<typename CharT>
+		ProcessorAcceptRef Search(CharT const* str, std::size_t offset = 0)
+		{
+			return Search(std::basic_string_view<CharT>(str), offset);
+		}
+
+		// Only for the capture free table created from an unanchored Nfa with RemoveCapture(false), find the end of the leftmost match
+		// with a single forward pass, then walk Reverse back from the end to find its begin. The captures are not reported,
+		// run Process from the begin with an anchored table when they are required.
+		template<typename CharT, typename CharTraits>
+		ProcessorAcceptRef ReverseSearch(ReverseDfa const& Reverse, std::basic_string_view<CharT, CharTraits> str, std::size_t offset = 0);
+		template<typename CharT>
+		ProcessorAcceptRef ReverseSearch(ReverseDfa const& Reverse, CharT const* str, std::size_t offset = 0)
+		{
+			return ReverseSearch(Reverse, std::basic_string_view<CharT>(str), offset);
+		}
+
+		template<typename CharT, typename CharTraits>
+		struct SearchRange;
+
+		// Iterate all the non overlapping matches from offset with Search.
+		template<typename CharT, typename CharTraits>
+		SearchRange<CharT, CharTraits> FindAll(std::basic_string_view<CharT, CharTraits> str, std::size_t offset = 0);
+		template<typename CharT>
+		SearchRange<CharT, std::char_traits<CharT>> FindAll(CharT const* str, std::size_t offset = 0)
+		{
+			return FindAll(std::basic_string_view<CharT>(str), offset);
+		}
+
+		// Try Process at every position from offset and return the first accept, positions rejected by the prefilter are skipped.
+		template<typename CharT, typename CharTraits>
+		ProcessorAcceptRef ScanProcess(std::basic_string_view<CharT, CharTraits> str, std::size_t offset = 0);
+		template<typename CharT>
+		ProcessorAcceptRef ScanProcess(CharT const* str, std::size_t offset = 0)
+		{
+			return ScanProcess(std::basic_string_view<CharT>(str), offset);
+		}
+
+	protected:
+
+		std::variant<
+			std::monostate,
+			std::reference_wrapper<Dfa const>,
+			DfaBinaryTableWrapper,
+			std::reference_wrapper<LazyDfa>,
+			std::reference_wrapper<BitParallelNfa const>
+		> TableWrapper;
+
+		std::size_t CurNodeIndex = 0;
+		std::uint64_t PositionState = 0;
+		std::pmr::vector<std::size_t> TempResult;
+		std::pmr::vector<std::size_t> CacheIndex;
+		TokenIndexRecorder Record;
+		std::size_t Utf8State = 0;
+		std::size_t Utf8CharStart = 0;
+
+		friend struct Dfa;
+		friend struct DfaBinaryTableWrapper;
+		friend struct LazyDfa;
+		friend struct BitParallelNfa;
+		friend struct DfaBatchProcessor;
+		friend struct DfaStreamMatcher;
+	};
+
+	template<typename CharT, typename CharTraits>
+	ProcessorAcceptRef DfaProcessor::Process(std::basic_string_view<CharT, CharTraits> str, std::size_t offset)
+	{
+		assert(offset <= str.size());
+
+		if constexpr (sizeof(CharT) == sizeof(char8_t))
+		{
+			if (HasUtf8Table())
+			{
+				if (FragmentProcess(std::span(reinterpret_cast<char8_t const*>(str.data()), str.size()).subspan(offset), offset))
+				{
+					if (Utf8State == 0)
+						EndOfFile(str.size());
+				}
+				return GetAccept();
+			}
+		}
+
+		std::array<CodePointT, Encode::Unicode::temporary_cache_buffer_size> temp_buffer;
+		std::array<std::size_t, Encode::Unicode::temporary_cache_buffer_size> source_index;
+		
+		auto ite_str = std::span(str).subspan(offset);
+		std::size_t token_index = offset;
+
+		while (!ite_str.empty())
+		{
+			auto info = Encode::UnicodeEncoder<CharT, CodePointT>::EncodeTo(ite_str, temp_buffer, {}, source_index, token_index);
+			if (info.target_space == 0)
+				return GetAccept();
+
+			// EncodeTo records where each code point ends, but Consume requires where it begins.
+			for (std::size_t index = info.target_space; index > 1; --index)
+				source_index[index - 1] = source_index[index - 2];
+			source_index[0] = token_index;
+
+			auto result = FragmentProcess(
+				std::span(temp_buffer).subspan(0, info.target_space),
+				std::span(source_index).subspan(0, info.target_space)
+				);
+
+			if (!result)
+				return GetAccept();
+			ite_str = ite_str.subspan(info.source_space);
+			token_index += info.source_space;
+		}
+		EndOfFile(token_index);
+		return GetAccept();
+	}
+
+	template<typename CharT, typename CharTraits>
+	ProcessorAcceptRef DfaProcessor::Search(std::basic_string_view<CharT, CharTraits> str, std::size_t offset)
+	{
+		assert(IsUnanchored());
+		Clear();
+		auto accept = Process(str, offset);
+		if (accept)
+		{
+			assert(accept.Capture.size() >= 2);
+			accept.MainCapture = { accept.Capture[0], accept.Capture[1] };
+			accept.Capture = accept.Capture.subspan(2);
+		}
+		return accept;
+	}
+
+	template<typename CharT, typename CharTraits>
+	ProcessorAcceptRef DfaProcessor::ReverseSearch(ReverseDfa const& Reverse, std::basic_string_view<CharT, CharTraits> str, std::size_t offset)
+	{
+		assert(IsUnanchored());
+		Clear();
+		auto accept = Process(str, offset);
+		if (accept)
+		{
+			auto end = accept.GetMainCapture().End();
+			auto begin = Reverse.FindStart(str, accept.GetMask(), end, offset);
+			if (!begin.has_value())
+				return {};
+			accept.MainCapture = { *begin, end };
+			accept.Capture = {};
+		}
+		return accept;
+	}
+
+	template<typename CharT, typename CharTraits>
+	struct DfaProcessor::SearchRange
+	{
+		struct Sentinel {};
+
+		struct Iterator
+		{
+			SearchRange* Owner = nullptr;
+			ProcessorAcceptRef const& operator*() const { return Owner->Current; }
+			ProcessorAcceptRef const* operator->() const { return &Owner->Current; }
+			Iterator& operator++() { Owner->Next(); return *this; }
+			bool operator==(Sentinel) const { return !Owner->Current; }
+		};
+
+		SearchRange(DfaProcessor& processor, std::basic_string_view<CharT, CharTraits> str, std::size_t offset)
+			: Processor(processor), Str(str), Offset(offset) {}
+
+		Iterator begin() { Next(); return { this }; }
+		Sentinel end() const { return {}; }
+
+	protected:
+
+		void Next()
+		{
+			if (Offset > Str.size())
+			{
+				Current = {};
+				return;
+			}
+			Current = Processor.Search(Str, Offset);
+			if (Current)
+			{
+				auto end = Current.GetMainCapture().End();
+				if (end > Offset)
+					Offset = end;
+				else if(Offset < Str.size())
+				{
+					CodePointT temp = 0;
+					Encode::EncodeCutOffSetting cutoff;
+					cutoff.max_character_count = 1;
+					auto info = Encode::UnicodeEncoder<CharT, CodePointT>::EncodeTo(std::span(Str).subspan(Offset), std::span(&temp, 1), cutoff);
+					Offset += std::max(info.source_space, std::size_t(1));
+				}
+				else
+					Offset = Str.size() + 1;
+			}
+		}
+
+		DfaProcessor& Processor;
+		std::basic_string_view<CharT, CharTraits> Str;
+		std::size_t Offset = 0;
+		ProcessorAcceptRef Current;
+	};
+
+	template<typename CharT, typename CharTraits>
+	auto DfaProcessor::FindAll(std::basic_string_view<CharT, CharTraits> str, std::size_t offset) -> SearchRange<CharT, CharTraits>
+	{
+		return { *this, str, offset };
+	}
+
+	template<typename CharT, typename CharTraits>
+	ProcessorAcceptRef DfaProcessor::ScanProcess(std::basic_string_view<CharT, CharTraits> str, std::size_t offset)
+	{
+		std::optional<Prefilter> filter;
+		if constexpr (sizeof(CharT) == sizeof(char8_t))
+		{
+			filter = GetPrefilter();
+			if (!filter->IsAvailable())
+				filter.reset();
+		}
+
+		while (offset <= str.size())
+		{
+			if (filter.has_value())
+			{
+				auto candidate = filter->Find(std::span(reinterpret_cast<char8_t const*>(str.data()), str.size()), offset);
+				if (!candidate.has_value())
+					break;
+				offset = *candidate;
+			}
+
+			Clear();
+			auto accept = Process(str, offset);
+			if (accept)
+				return accept;
+
+			if (offset == str.size())
+				break;
+
+			CodePointT temp = 0;
+			Encode::EncodeCutOffSetting cutoff;
+			cutoff.max_character_count = 1;
+			auto info = Encode::UnicodeEncoder<CharT, CodePointT>::EncodeTo(std::span(str).subspan(offset), std::span(&temp, 1), cutoff);
+			offset += std::max(info.source_space, std::size_t(1));
+		}
+		Clear();
+		return {};
+	}
+
+	struct ProcessorBatchAccept
+	{
+		std::optional<std::size_t> Mask;
+		Misc::IndexSpan<> MainCapture;
+		Misc::IndexSpan<> CaptureIndex;
+		operator bool() const { return Mask.has_value(); }
+	};
+
+	// Match a batch of short strings against the same table.
+	// Several independent walks are interleaved in one thread to hide the latency of the table lookup,
+	// the batch can also be split into continuous chunks processed by different threads.
+	struct DfaBatchProcessor
+	{
+		static constexpr std::size_t LaneCount = 4;
+
+		DfaBatchProcessor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Prototype(resource), Results(resource), Captures(resource) {}
+
+		void SetObserverTable(Dfa const& Table) { Prototype.SetObserverTable(Table); }
+		void SetObserverTable(DfaBinaryTableWrapper Table) { Prototype.SetObserverTable(Table); }
+
+		// The token index in result is relative to each string. ThreadCount 0 means std::thread::hardware_concurrency.
+		template<typename CharT, typename CharTraits>
+		std::span<ProcessorBatchAccept const> Process(std::span<std::basic_string_view<CharT, CharTraits> const> strs, std::size_t thread_count = 1);
+
+		std::size_t GetResultCount() const { return Results.size(); }
+		ProcessorAcceptRef GetAccept(std::size_t Index) const
+		{
+			auto& Ref = Results[Index];
+			return { Ref.Mask, Ref.CaptureIndex.Slice(std::span(Captures)), Ref.MainCapture };
+		}
+		ProcessorAcceptRef operator[](std::size_t Index) const { return GetAccept(Index); }
+
+	protected:
+
+		static constexpr std::size_t MinChunkSize = 1024;
+
+		static constexpr std::size_t DecodeBlockSize = 16;
+
+		template<typename CharT, typename CharTraits>
+		static void ProcessChunk(DfaProcessor const& Prototype, std::span<std::basic_string_view<CharT, CharTraits> const> strs, std::span<ProcessorBatchAccept> output, std::vector<std::size_t>& captures);
+
+		// the lanes step the typed table directly, DfaProcessor is only the state of the walk
+		template<typename TableT, typename CharT, typename CharTraits>
+		static void ProcessChunk(TableT const& Table, std::span<std::basic_string_view<CharT, CharTraits> const> strs, std::span<ProcessorBatchAccept> output, std::vector<std::size_t>& captures);
+
+		DfaProcessor Prototype;
+		std::pmr::vector<ProcessorBatchAccept> Results;
+		std::pmr::vector<std::size_t> Captures;
+	};
+
+	template<typename CharT, typename CharTraits>
+	void DfaBatchProcessor::ProcessChunk(DfaProcessor const& Prototype, std::span<std::basic_string_view<CharT, CharTraits> const> strs, std::span<ProcessorBatchAccept> output, std::vector<std::size_t>& captures)
+	{
+		if (std::holds_alternative<std::reference_wrapper<Dfa const>>(Prototype.TableWrapper))
+			ProcessChunk(std::get<std::reference_wrapper<Dfa const>>(Prototype.TableWrapper).get(), strs, output, captures);
+		else
+			ProcessChunk(std::get<DfaBinaryTableWrapper>(Prototype.TableWrapper), strs, output, captures);
+	}
+
+	template<typename TableT, typename CharT, typename CharTraits>
+	void DfaBatchProcessor::ProcessChunk(TableT const& Table, std::span<std::basic_string_view<CharT, CharTraits> const> strs, std::span<ProcessorBatchAccept> output, std::vector<std::size_t>& captures)
+	{
+		struct LaneT
+		{
+			DfaProcessor Context;
+			std::size_t StrIndex = 0;
+			std::size_t Offset = 0;
+			std::size_t DecodeIndex = 0;
+			std::size_t DecodeCount = 0;
+			std::array<CodePointT, DecodeBlockSize> CodePoints;
+			std::array<std::size_t, DecodeBlockSize> TokenIndexs;
+			bool Active = false;
+		};
+
+		bool ByteLevel = false;
+		if constexpr (sizeof(CharT) == sizeof(char8_t))
+			ByteLevel = Table.HasUtf8Table();
+
+		auto Utf8Step = [&](std::size_t State, char8_t Byte) -> std::size_t {
+			if constexpr (std::is_same_v<TableT, Dfa>)
+				return Table.GetUtf8Table().Step(State, Byte);
+			else
+				return Table.Utf8Step(State, Byte);
+		};
+
+		std::size_t StartupNode = Table.GetStartupNodeIndex();
+		std::size_t CacheCount = Table.GetCacheCounterCount();
+		std::size_t TempResultCount = Table.GetTempResultCount();
+
+		std::array<LaneT, LaneCount> Lanes;
+		std::size_t NextStr = 0;
+		std::size_t ActiveCount = 0;
+
+		auto Finish = [&](LaneT& Lane) {
+			auto Accept = Table.GetAccept(Lane.Context);
+			auto& Tar = output[Lane.StrIndex];
+			Tar.Mask = Accept.Mask;
+			Tar.MainCapture = Accept.MainCapture;
+			Tar.CaptureIndex = { captures.size(), captures.size() + Accept.Capture.size() };
+			captures.insert(captures.end(), Accept.Capture.begin(), Accept.Capture.end());
+			Lane.Active = false;
+			--ActiveCount;
+		};
+
+		auto Start = [&](LaneT& Lane) {
+			while (NextStr < strs.size())
+			{
+				Lane.StrIndex = NextStr++;
+				Lane.Offset = 0;
+				Lane.DecodeIndex = 0;
+				Lane.DecodeCount = 0;
+				Lane.Context.CurNodeIndex = StartupNode;
+				Lane.Context.CacheIndex.assign(CacheCount, 0);
+				Lane.Context.TempResult.clear();
+				Lane.Context.TempResult.reserve(TempResultCount);
+				Lane.Context.Record.Clear();
+				Lane.Context.Utf8State = 0;
+				Lane.Active = true;
+				++ActiveCount;
+				if (!strs[Lane.StrIndex].empty())
+					return;
+				Table.Consume(Lane.Context, Reg::EndOfFile(), 0);
+				Finish(Lane);
+			}
+		};
+
+		for (auto& Ite : Lanes)
+			Start(Ite);
+
+		while (ActiveCount != 0)
+		{
+			for (auto& Ite : Lanes)
+			{
+				if (!Ite.Active)
+					continue;
+
+				auto Str = strs[Ite.StrIndex];
+				bool Continue = false;
+
+				if (ByteLevel)
+				{
+					auto& Context = Ite.Context;
+					if (Context.Utf8State == 0)
+						Context.Utf8CharStart = Ite.Offset;
+					auto Entry = Utf8Step(Context.Utf8State, static_cast<char8_t>(Str[Ite.Offset]));
+					if (Entry == Utf8ClassTable::InvalidEntry)
+					{
+						Context.Utf8State = 0;
+					}
+					else if (Utf8ClassTable::IsClassEntry(Entry))
+					{
+						Context.Utf8State = 0;
+						Continue = Table.ConsumeClass(Context, Utf8ClassTable::GetEntryValue(Entry), Context.Utf8CharStart);
+					}
+					else {
+						Context.Utf8State = Utf8ClassTable::GetEntryValue(Entry);
+						Continue = true;
+					}
+					Ite.Offset += 1;
+					if (Continue && Ite.Offset == Str.size())
+					{
+						if (Context.Utf8State == 0)
+							Table.Consume(Context, Reg::EndOfFile(), Str.size());
+						Continue = false;
+					}
+				}
+				else {
+					if (Ite.DecodeIndex == Ite.DecodeCount)
+					{
+						auto Info = Encode::UnicodeEncoder<CharT, CodePointT>::EncodeTo(std::span(Str).subspan(Ite.Offset), std::span(Ite.CodePoints), {}, std::span(Ite.TokenIndexs), Ite.Offset);
+						// EncodeTo records where each code point ends, but Consume requires where it begins.
+						for (std::size_t Index = Info.target_space; Index > 1; --Index)
+							Ite.TokenIndexs[Index - 1] = Ite.TokenIndexs[Index - 2];
+						Ite.TokenIndexs[0] = Ite.Offset;
+						Ite.DecodeIndex = 0;
+						Ite.DecodeCount = Info.target_space;
+						Ite.Offset += Info.source_space;
+					}
+					if (Ite.DecodeIndex < Ite.DecodeCount)
+					{
+						Continue = Table.Consume(Ite.Context, Ite.CodePoints[Ite.DecodeIndex], Ite.TokenIndexs[Ite.DecodeIndex]);
+						++Ite.DecodeIndex;
+						if (Continue && Ite.DecodeIndex == Ite.DecodeCount && Ite.Offset == Str.size())
+						{
+							Table.Consume(Ite.Context, Reg::EndOfFile(), Str.size());
+							Continue = false;
+						}
+					}
+				}
+
+				if (!Continue)
+				{
+					Finish(Ite);
+					Start(Ite);
+				}
+			}
+		}
+	}
+
+	template<typename CharT, typename CharTraits>
+	std::span<ProcessorBatchAccept const> DfaBatchProcessor::Process(std::span<std::basic_string_view<CharT, CharTraits> const> strs, std::size_t thread_count)
+	{
+		Results.clear();
+		Captures.clear();
+		Results.resize(strs.size());
+
+		if (thread_count == 0)
+			thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+		thread_count = std::min(thread_count, std::max(strs.size() / MinChunkSize, std::size_t(1)));
+
+		std::vector<std::vector<std::size_t>> ChunkCaptures;
+		ChunkCaptures.resize(thread_count);
+		std::size_t ChunkSize = (strs.size() + thread_count - 1) / std::max(thread_count, std::size_t(1));
+
+		if (thread_count <= 1)
+		{
+			ProcessChunk(Prototype, strs, std::span(Results), ChunkCaptures[0]);
+		}
+		else {
+			std::vector<std::jthread> Threads;
+			Threads.reserve(thread_count - 1);
+			for (std::size_t I = 1; I < thread_count; ++I)
+			{
+				auto Begin = std::min(I * ChunkSize, strs.size());
+				auto End = std::min(Begin + ChunkSize, strs.size());
+				Threads.emplace_back([&, Begin, End, I]() {
+					ProcessChunk(Prototype, strs.subspan(Begin, End - Begin), std::span(Results).subspan(Begin, End - Begin), ChunkCaptures[I]);
+				});
+			}
+			auto End = std::min(ChunkSize, strs.size());
+			ProcessChunk(Prototype, strs.subspan(0, End), std::span(Results).subspan(0, End), ChunkCaptures[0]);
+		}
+
+		for (std::size_t I = 0; I < thread_count; ++I)
+		{
+			std::size_t Base = Captures.size();
+			if (I != 0 && Base != 0)
+			{
+				auto Begin = std::min(I * ChunkSize, strs.size());
+				auto End = std::min(Begin + ChunkSize, strs.size());
+				for (auto& Ite : std::span(Results).subspan(Begin, End - Begin))
+					Ite.CaptureIndex = { Ite.CaptureIndex.Begin() + Base, Ite.CaptureIndex.End() + Base };
+			}
+			Captures.insert(Captures.end(), ChunkCaptures[I].begin(), ChunkCaptures[I].end());
+		}
+
+		return Results;
+	}
+
+	// Search all the non overlapping matches of an unanchored table in a stream, the input is pulled in blocks of BlockSize.
+	// Only the bytes which may be consumed again by the next search are retained, so the memory is bounded by the length of the match.
+	// Token index in result is the absolute offset of utf8 code unit in the stream, for PlainTextReader it is the offset in the decoded text.
+	struct DfaStreamMatcher
+	{
+		static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+		DfaStreamMatcher(Streamer::StreamReader& Reader, std::size_t BlockSize = DefaultBlockSize, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Source(std::reference_wrapper<Streamer::StreamReader>{Reader}), BlockSize(std::max(BlockSize, std::size_t(1))), Processor(resource), Buffer(resource) {}
+		DfaStreamMatcher(Document::PlainTextReader& Reader, std::size_t BlockSize = DefaultBlockSize, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Source(std::reference_wrapper<Document::PlainTextReader>{Reader}), BlockSize(std::max(BlockSize, std::size_t(1))), Processor(resource), Buffer(resource) {}
+		DfaStreamMatcher(DfaStreamMatcher const&) = delete;
+
+		void SetObserverTable(Dfa const& Table) { Processor.SetObserverTable(Table); assert(Processor.IsUnanchored()); }
+		void SetObserverTable(DfaBinaryTableWrapper Table) { Processor.SetObserverTable(Table); assert(Processor.IsUnanchored()); }
+
+		// Return the next match, or an empty result at the end of the stream. The result is available until the next call.
+		ProcessorAcceptRef Next();
+
+		// The bytes of the main capture or a capture of the result of Next, available until the next call.
+		std::u8string_view GetString(Misc::IndexSpan<> Span) const;
+
+		std::size_t GetSearchOffset() const { return SearchOffset; }
+		std::size_t GetRetainedSize() const { return Buffer.size(); }
+
+	protected:
+
+		static constexpr std::size_t NoLocation = std::numeric_limits<std::size_t>::max();
+
+		bool FillBlock(std::size_t KeepOffset);
+		bool Require(std::size_t Offset, std::size_t KeepOffset);
+
+		std::variant<
+			std::reference_wrapper<Streamer::StreamReader>,
+			std::reference_wrapper<Document::PlainTextReader>
+		> Source;
+		std::size_t BlockSize = DefaultBlockSize;
+		DfaProcessor Processor;
+		std::pmr::vector<char8_t> Buffer;
+		std::size_t BufferOffset = 0;
+		std::size_t SearchOffset = 0;
+		bool SourceEnd = false;
+		bool Finish = false;
+	};
+
+	/*
+	template<typename CharT, typename CharTraidT>
+	ProcessorAcceptRef Process(DfaProcessor& processor, std::basic_string_view<CharT, CharTraidT> str)
+	{
+		std::array<CodePointT, Encode::Unicode::temporary_cache_buffer_size> temp_buffer;
+		std::array<std::size_t, Encode::Unicode::temporary_cache_buffer_size> source_index;
+
+		auto ite_str = std::span(str);
+
+		bool need_end_of_file = true;
+
+		std::size_t token_index = 0;
+
+		while (!ite_str.empty() && need_end_of_file)
+		{
+			auto info = Encode::UnicodeEncoder<CharT, CodePointT>::EncodeTo(ite_str, temp_buffer, std::numeric_limits<std::size_t>::max(), source_index);
+			for(std::size_t index = 0; index < info.target_space; ++index)
+			{
+				std::size_t current_token_index = token_index;
+				if (index != 0)
+				{
+					current_token_index += source_index[index - 1];
+				}
+				auto re = processor.Consume(temp_buffer[index], current_token_index);
+				
+				if (!re)
+				{
+					need_end_of_file = false;
+					break;
+				}
+			}
+			ite_str = ite_str.subspan(info.source_space);
+			token_index += info.source_space;
+		}
+
+		if (need_end_of_file)
+			processor.EndOfFile(token_index);
+
+		return processor.GetAccept();
+	}
+
+	template<typename ProcessorT, typename CharT>
+	ProcessorAcceptRef Process(ProcessorT& Pro, CharT const* Str)
+	{
+		return Process(Pro, std::basic_string_view<CharT>(Str));
+	}
+
+	template<typename CharT, typename CharTrais, typename Func>
+	void Process(Dfa const& Table, std::basic_string_view<CharT, CharTrais> Str, Func&& Fun)
+	{
+		DfaProcessor Processor;
+		Processor.SetObserverTable(Table);
+		Fun(Process(Processor, Str));
+	}
+
+	template<typename CharT, typename Func>
+	void Process(Dfa const& Table, CharT const* Str, Func&& Fun)
+	{
+		Process(Table, std::basic_string_view<CharT>(Str), std::forward<Func>(Fun));
+	}
+	*/
+
+	// Double array trie of the literal patterns over the utf8 code unit, find the longest literal at the beginning of the string.
+	struct LiteralTable
+	{
+		struct LiteralT
+		{
+			std::u8string_view Literal;
+			std::size_t Mask = 0;
+			std::size_t Priority = 0;
+		};
+
+		struct AcceptT
+		{
+			std::size_t Mask = 0;
+			std::size_t Priority = 0;
+			std::size_t End = 0;
+		};
+
+		LiteralTable() = default;
+		LiteralTable(std::span<LiteralT const> Literals);
+		LiteralTable(LiteralTable const&) = default;
+		LiteralTable(LiteralTable&&) = default;
+		LiteralTable& operator=(LiteralTable const&) = default;
+		LiteralTable& operator=(LiteralTable&&) = default;
+
+		bool Empty() const { return Accepts.empty(); }
+		std::size_t GetNodeCount() const { return Base.size(); }
+
+		template<typename CharT, typename CharTraits>
+		std::optional<AcceptT> HeadMatch(std::basic_string_view<CharT, CharTraits> Str, std::size_t Offset = 0) const;
+
+	protected:
+
+		static constexpr std::uint32_t NoCheck = std::numeric_limits<std::uint32_t>::max();
+
+		std::optional<std::size_t> Step(std::size_t Node, char8_t Byte) const
+		{
+			std::size_t Next = Base[Node] + Byte;
+			if (Next < Check.size() && Check[Next] == Node)
+				return Next;
+			return std::nullopt;
+		}
+
+		std::vector<std::uint32_t> Base;
+		std::vector<std::uint32_t> Check;
+		std::vector<std::uint32_t> AcceptIndex;
+		std::vector<AcceptT> Accepts;
+	};
+
+	template<typename CharT, typename CharTraits>
+	auto LiteralTable::HeadMatch(std::basic_string_view<CharT, CharTraits> Str, std::size_t Offset) const -> std::optional<AcceptT>
+	{
+		assert(Offset <= Str.size());
+
+		if (Accepts.empty())
+			return std::nullopt;
+
+		std::optional<AcceptT> Result;
+		std::size_t Node = 0;
+
+		if constexpr (sizeof(CharT) == sizeof(char8_t))
+		{
+			for (std::size_t Index = Offset; Index < Str.size(); ++Index)
+			{
+				auto Next = Step(Node, static_cast<char8_t>(Str[Index]));
+				if (!Next.has_value())
+					break;
+				Node = *Next;
+				if (AcceptIndex[Node] != 0)
+				{
+					Result = Accepts[AcceptIndex[Node] - 1];
+					Result->End = Index + 1;
+				}
+			}
+		}
+		else {
+			auto Ite = std::span(Str).subspan(Offset);
+			std::size_t Index = Offset;
+			std::array<char8_t, Encode::Unicode::UTF8::max_storage_size> Temp;
+			Encode::EncodeCutOffSetting Cutoff;
+			Cutoff.max_character_count = 1;
+			while (!Ite.empty())
+			{
+				auto Info = Encode::UnicodeEncoder<CharT, char8_t>::EncodeTo(Ite, std::span(Temp), Cutoff);
+				if (Info.target_space == 0)
+					break;
+				bool Continue = true;
+				for (std::size_t I = 0; I < Info.target_space && Continue; ++I)
+				{
+					auto Next = Step(Node, Temp[I]);
+					if (Next.has_value())
+						Node = *Next;
+					else
+						Continue = false;
+				}
+				if (!Continue)
+					break;
+				Ite = Ite.subspan(Info.source_space);
+				Index += Info.source_space;
+				if (AcceptIndex[Node] != 0)
+				{
+					Result = Accepts[AcceptIndex[Node] - 1];
+					Result->End = Index;
+				}
+			}
+		}
+
+		return Result;
+	}
+
+	// Created by MulityRegCreater::CreateMulityRegTable, the literal patterns are matched by the LiteralTable and the others by a GreedyHeadMatch Dfa.
+	// The longer match wins, on the same length the one appended first wins.
+	struct MulityRegTable
+	{
+		std::optional<Dfa> const& GetRegTable() const { return RegTable; }
+		LiteralTable const& GetLiteralTable() const { return Literals; }
+
+		template<typename CharT, typename CharTraits>
+		ProcessorAcceptRef Process(DfaProcessor& Processor, std::basic_string_view<CharT, CharTraits> Str, std::size_t Offset = 0) const;
+		template<typename CharT>
+		ProcessorAcceptRef Process(DfaProcessor& Processor, CharT const* Str, std::size_t Offset = 0) const
+		{
+			return Process(Processor, std::basic_string_view<CharT>(Str), Offset);
+		}
+
+	protected:
+
+		// the mask of RegTable is the append index of the pattern
+		std::optional<Dfa> RegTable;
+		LiteralTable Literals;
+		std::vector<std::size_t> Masks;
+
+		friend struct MulityRegCreater;
+	};
+
+	template<typename CharT, typename CharTraits>
+	ProcessorAcceptRef MulityRegTable::Process(DfaProcessor& Processor, std::basic_string_view<CharT, CharTraits> Str, std::size_t Offset) const
+	{
+		ProcessorAcceptRef RegAccept;
+		if (RegTable.has_value())
+		{
+			Processor.SetObserverTable(*RegTable);
+			RegAccept = Processor.Process(Str, Offset);
+		}
+
+		auto LiteralAccept = Literals.HeadMatch(Str, Offset);
+		if (LiteralAccept.has_value())
+		{
+			bool UseLiteral = !RegAccept || LiteralAccept->End > RegAccept.MainCapture.End();
+			if (!UseLiteral && LiteralAccept->End == RegAccept.MainCapture.End())
+				UseLiteral = LiteralAccept->Priority < *RegAccept.Mask;
+			if (UseLiteral)
+			{
+				ProcessorAcceptRef Result;
+				Result.Mask = LiteralAccept->Mask;
+				Result.MainCapture = { Offset, LiteralAccept->End };
+				return Result;
+			}
+		}
+		if (RegAccept)
+			RegAccept.Mask = Masks[*RegAccept.Mask];
+		return RegAccept;
+	}
+
+	struct MulityRegCreater
+	{
+		template<typename CharT, typename CharTraits>
+		void AppendReg(std::basic_string_view<CharT, CharTraits> Str, bool IsRaw, std::size_t Mask)
+		{
+			PatternT Pattern{ {}, IsRaw, Mask };
+			Encode::UnicodeEncoder<CharT, char32_t>::EncodeTo(Str, std::back_insert_iterator(Pattern.Str));
+
+			auto Literal = ExtractLiteral(std::u32string_view{ Pattern.Str }, IsRaw);
+			if (Literal.has_value())
+				Literals.push_back({ std::move(*Literal), Mask, Patterns.size() });
+			else
+				Pattern.Table.emplace(std::u32string_view{ Pattern.Str }, IsRaw, Patterns.size());
+			Patterns.push_back(std::move(Pattern));
+		}
+
+		template<typename CharT>
+		void AppendReg(CharT const* Str, bool IsRaw, std::size_t Mask)
+		{
+			return AppendReg(std::basic_string_view<CharT>(Str), IsRaw, Mask);
+		}
+
+		std::optional<Dfa> CreateDfa(Dfa::FormatE Format, bool CaptureFree = false, std::size_t ThreadCount = 1) const {
+			auto Table = CreateNfa();
+			if (!Table.has_value())
+				return {};
+			if (CaptureFree)
+				Table->RemoveCapture();
+			return Dfa{ Format, *Table, ThreadCount };
+		}
+		std::optional<Dfa> CreateUnanchoredDfa(Dfa::FormatE Format) const { auto Table = CreateNfa(); if (Table.has_value()) { Table->MakeUnanchored(); return Dfa{ Format, *Table }; } return {}; }
+		// Capture free unanchored Dfa and the ReverseDfa for DfaProcessor::ReverseSearch.
+		std::optional<std::tuple<Dfa, ReverseDfa>> CreateReverseSearchDfa(Dfa::FormatE Format) const {
+			auto Table = CreateNfa();
+			if (!Table.has_value())
+				return {};
+			auto Temp = *Table;
+			Temp.MakeUnanchored();
+			Temp.RemoveCapture(false);
+			return std::tuple<Dfa, ReverseDfa>{ Dfa{ Format, Temp }, ReverseDfa{ *Table } };
+		}
+		std::optional<LazyDfa> CreateLazyDfa(Dfa::FormatE Format, std::size_t MaxStateCount = 1024) const { auto Table = CreateNfa(); if (Table.has_value())  return LazyDfa{ Format, *Table, MaxStateCount }; return {}; }
+		std::optional<std::variant<Dfa, LazyDfa>> CreateHybridDfa(Dfa::FormatE Format, std::size_t MaxStateCount = 4096, std::size_t MaxLazyStateCount = 1024) const { auto Table = CreateNfa(); if (Table.has_value()) return Reg::CreateHybridDfa(Format, *Table, MaxStateCount, MaxLazyStateCount); return {}; }
+
+		// Use the BitParallelNfa when the patterns are small enough, otherwise fall back to the Dfa.
+		std::optional<std::variant<BitParallelNfa, Dfa>> CreateMatchTable() const {
+			auto Table = CreateNfa();
+			if (!Table.has_value())
+				return {};
+			if (BitParallelNfa::IsAvailable(*Table))
+				return std::variant<BitParallelNfa, Dfa>{ std::in_place_index<0>, *Table };
+			return std::variant<BitParallelNfa, Dfa>{ std::in_place_index<1>, Dfa::FormatE::Match, *Table };
+		}
+
+		template<typename AllocatorT = std::allocator<DfaBinaryTableWrapper::StandardT>>
+		std::optional<std::vector<DfaBinaryTableWrapper::StandardT>> CreateDfaBinary(Dfa::FormatE Format, AllocatorT Allocator = {}) const { auto Table = CreateNfa(); if (Table.has_value())  return CreateDfaBinaryTable(Dfa{Format, *Table}, std::move(Allocator)); return {}; }
+
+		// Only the patterns which are not literal go through the Dfa construction.
+		std::optional<MulityRegTable> CreateMulityRegTable() const;
+
+		// Return the utf8 string if the pattern only matches itself.
+		template<typename CharT, typename CharTraits>
+		static std::optional<std::u8string> ExtractLiteral(std::basic_string_view<CharT, CharTraits> Str, bool IsRaw);
+	
+	protected:
+
+		// Link the Nfa of all the patterns, the literal patterns are only parsed here, the others reuse the Nfa parsed by AppendReg.
+		std::optional<Nfa> CreateNfa() const;
+
+		struct PatternT
+		{
+			std::u32string Str;
+			bool IsRaw = false;
+			std::size_t Mask = 0;
+			// the mask of Table is the append index of the pattern, empty for the literal patterns
+			std::optional<Nfa> Table;
+		};
+
+		struct LiteralT
+		{
+			std::u8string Literal;
+			std::size_t Mask = 0;
+			std::size_t Priority = 0;
+		};
+
+		std::vector<PatternT> Patterns;
+		std::vector<LiteralT> Literals;
+	};
+
+	template<typename CharT, typename CharTraits>
+	std::optional<std::u8string> MulityRegCreater::ExtractLiteral(std::basic_string_view<CharT, CharTraits> Str, bool IsRaw)
+	{
+		std::u32string Temp;
+		Encode::UnicodeEncoder<CharT, char32_t>::EncodeTo(Str, std::back_insert_iterator(Temp));
+		if (Temp.empty())
+			return std::nullopt;
+
+		std::u32string Literal;
+
+		if (IsRaw)
+			Literal = std::move(Temp);
+		else {
+			for (std::size_t Index = 0; Index < Temp.size(); ++Index)
+			{
+				auto Cur = Temp[Index];
+				switch (Cur)
+				{
+				case U'[': case U']': case U'{': case U'}': case U'(': case U')':
+				case U'*': case U'?': case U'.': case U'|': case U'+': case U'^':
+				case U'-': case U',': case U':':
+					return std::nullopt;
+				case U'\\':
+				{
+					++Index;
+					if (Index >= Temp.size())
+						return std::nullopt;
+					switch (Temp[Index])
+					{
+					case U'f': Literal.push_back(U'\f'); break;
+					case U'n': Literal.push_back(U'\n'); break;
+					case U'r': Literal.push_back(U'\r'); break;
+					case U't': Literal.push_back(U'\t'); break;
+					case U'v': Literal.push_back(U'\v'); break;
+					case U'd': case U'D': case U's': case U'S': case U'w': case U'W': case U'z': case U'u': case U'U':
+						return std::nullopt;
+					default:
+						Literal.push_back(Temp[Index]);
+						break;
+					}
+					break;
+				}
+				default:
+					Literal.push_back(Cur);
+					break;
+				}
+			}
+		}
+
+		for (auto Ite : Literal)
+		{
+			if (Ite == 0 || Ite >= MaxChar())
+				return std::nullopt;
+		}
+
+		std::u8string Result;
+		Encode::UnicodeEncoder<char32_t, char8_t>::EncodeTo(std::u32string_view{ Literal }, std::back_insert_iterator(Result));
+		return Result;
+	}
+
+	// Thread safe LRU cache of the binary tables compiled from the pattern text, keyed by (pattern, IsRaw, Mask, Format).
+	// The tables are immutable and stay valid as long as the Ptr is held, even after they are evicted.
+	struct DfaTableCache
+	{
+		struct Table
+		{
+			struct Wrapper
+			{
+				void AddRef(Table const* ptr) { ptr->Ref.fetch_add(1, std::memory_order_relaxed); }
+				// the table is shared between threads, so the last release has to see all the reads of the others
+				void SubRef(Table const* ptr) { if (ptr->Ref.fetch_sub(1, std::memory_order_acq_rel) == 1) delete ptr; }
+			};
+
+			using Ptr = Pointer::IntrusivePtr<Table const, Wrapper>;
+
+			DfaBinaryTableWrapper GetWrapper() const { return DfaBinaryTableWrapper{ std::span(Buffer) }; }
+			std::span<DfaBinaryTableWrapper::StandardT const> GetBuffer() const { return Buffer; }
+
+		protected:
+
+			Table(std::vector<DfaBinaryTableWrapper::StandardT> Buffer) : Buffer(std::move(Buffer)) {}
+
+			std::vector<DfaBinaryTableWrapper::StandardT> const Buffer;
+			mutable std::atomic_size_t Ref = 0;
+
+			friend struct DfaTableCache;
+		};
+
+		struct StatisticsT
+		{
+			std::size_t HitCount = 0;
+			std::size_t MissCount = 0;
+			std::size_t EvictionCount = 0;
+		};
+
+		DfaTableCache(std::size_t MaxTableCount = 256) : MaxTableCount(std::max(MaxTableCount, std::size_t(1))) {}
+		DfaTableCache(DfaTableCache const&) = delete;
+
+		// Compile the pattern on miss, the exception of a bad pattern is thrown to the caller and nothing is cached.
+		template<typename CharT, typename CharTraits>
+		Table::Ptr Get(Dfa::FormatE Format, std::basic_string_view<CharT, CharTraits> Str, bool IsRaw = false, std::size_t Mask = 0);
+		template<typename CharT>
+		Table::Ptr Get(Dfa::FormatE Format, CharT const* Str, bool IsRaw = false, std::size_t Mask = 0)
+		{
+			return Get(Format, std::basic_string_view<CharT>{ Str }, IsRaw, Mask);
+		}
+
+		StatisticsT GetStatistics() const;
+		std::size_t GetTableCount() const;
+		std::size_t GetMaxTableCount() const { return MaxTableCount; }
+		void Clear();
+
+	protected:
+
+		struct KeyViewT
+		{
+			std::u8string_view Pattern;
+			Dfa::FormatE Format;
+			bool IsRaw;
+			std::size_t Mask;
+			bool operator==(KeyViewT const&) const = default;
+		};
+
+		struct KeyT
+		{
+			std::u8string Pattern;
+			Dfa::FormatE Format;
+			bool IsRaw;
+			std::size_t Mask;
+			operator KeyViewT() const { return { Pattern, Format, IsRaw, Mask }; }
+		};
+
+		// transparent, so the lookup does not copy the pattern
+		struct KeyHashT
+		{
+			using is_transparent = void;
+			std::size_t operator()(KeyViewT const& Key) const;
+		};
+
+		struct KeyEqualT
+		{
+			using is_transparent = void;
+			bool operator()(KeyViewT const& T1, KeyViewT const& T2) const { return T1 == T2; }
+		};
+
+		using ListT = std::list<std::tuple<KeyT const*, Table::Ptr>>;
+
+		Table::Ptr GetUtf8(Dfa::FormatE Format, std::u8string_view Str, bool IsRaw, std::size_t Mask);
+
+		std::size_t const MaxTableCount;
+		mutable std::mutex Mutex;
+		// front is the most recently used one
+		ListT Tables;
+		std::unordered_map<KeyT, ListT::iterator, KeyHashT, KeyEqualT> Mapping;
+		StatisticsT Statistics;
+	};
+
+	template<typename CharT, typename CharTraits>
+	auto DfaTableCache::Get(Dfa::FormatE Format, std::basic_string_view<CharT, CharTraits> Str, bool IsRaw, std::size_t Mask) -> Table::Ptr
+	{
+		if constexpr (std::is_same_v<CharT, char8_t>)
+		{
+			return GetUtf8(Format, std::u8string_view{ Str.data(), Str.size() }, IsRaw, Mask);
+		}
+		else {
+			std::u8string Pattern;
+			Encode::UnicodeEncoder<CharT, char8_t>::EncodeTo(Str, std::back_insert_iterator(Pattern));
+			return GetUtf8(Format, std::u8string_view{ Pattern }, IsRaw, Mask);
+		}
+	}
 
 	namespace Exception
 	{
@@ -749,6 +2933,8 @@ export namespace Potato::Reg
 				Counter,
 				CaptureIndex,
 				Mask,
+				ClassCount,
+				StateCount,
 			};
 
 			TypeT Type;
@@ -37,6 +37,7 @@ namespace Potato::SLRX
 			Production Desc;
 			Desc.Symbol = Ite.ProductionValue;
 			Desc.ProductionMask = Ite.ProductionMask;
+			Desc.ReduceType = Ite.ReduceType;
 			std::size_t ElementIndex = 0;
 			for (auto& Ite2 : Ite.Element)
 			{
@@ -68,6 +69,10 @@ namespace Potato::SLRX
 				}
 				++ElementIndex;
 			}
+			if (Desc.ReduceType == ReduceTypeE::PassThrough && Desc.Elements.empty())
+			{
+				throw Exception::WrongProduction{ Exception::WrongProduction::Category::PassThroughWithoutElement, std::move(Ite) };
+			}
 			ProductionDescs.push_back(std::move(Desc));
 		}
 
@@ -351,11 +356,14 @@ namespace Potato::SLRX
 		return Temporary1;
 	}
 
-	LR0 LR0::Create(ProductionInfo Infos)
+	constexpr std::size_t ParallelTaskPerThread = 8;
+
+	LR0 LR0::Create(ProductionInfo Infos, std::size_t ThreadCount)
 	{
 		std::vector<Node> Nodes;
 		std::vector<ProductionInfo::SearchElement> Status;
 		std::vector<Misc::IndexSpan<>> PreNode;
+		std::map<std::vector<ProductionInfo::SearchElement>, std::size_t> StatusMapping;
 
 		Status.push_back(Infos.GetStartupSearchElements());
 		Infos.ExpandSearchElements(Status);
@@ -363,6 +371,12 @@ namespace Potato::SLRX
 		PreNode.push_back({ 0, Status.size() });
 		Status.push_back(Infos.GetEndSearchElements());
 
+		for (std::size_t Index = 0; Index < PreNode.size(); ++Index)
+		{
+			auto Cur = PreNode[Index].Slice(Status);
+			StatusMapping.insert({ std::vector<ProductionInfo::SearchElement>(Cur.begin(), Cur.end()), Index });
+		}
+
 		struct SearchProperty
 		{
 			std::optional<Symbol> ShiftSymbol;
@@ -377,23 +391,27 @@ namespace Potato::SLRX
 			bool ReserveStorage = false;
 		};
 
-		std::vector<SearchProperty> SearchPropertyTemporary;
-		std::vector<std::size_t> AccepatbelProductionIndexs;
-		std::vector<ShiftMapping> Mappings;
+		struct ExpandResult
+		{
+			Node TemporaryNode;
+			std::vector<std::size_t> AccepatbelProductionIndexs;
+			std::vector<ShiftMapping> Mappings;
+		};
 
-		for (std::size_t SearchIte = 0; SearchIte < PreNode.size(); ++SearchIte)
+		// closure and goto of one state, only read the shared data. The target state of the shift is interned later.
+		auto ExpandNode = [&](std::span<ProductionInfo::SearchElement const> CurrentState, ExpandResult& Output)
 		{
-			auto CurrentState = PreNode[SearchIte].Slice(std::span(Status.data(), Status.size()));
-			SearchPropertyTemporary.clear();
-			AccepatbelProductionIndexs.clear();
-			Mappings.clear();
+			std::vector<SearchProperty> SearchPropertyTemporary;
+			auto& AccepatbelProductionIndexs = Output.AccepatbelProductionIndexs;
+			auto& Mappings = Output.Mappings;
+			auto& TemporaryNode = Output.TemporaryNode;
+
 			SearchPropertyTemporary.reserve(CurrentState.size());
 			for (auto& Ite : CurrentState)
 			{
 				SearchProperty Pro{ Infos.GetElementSymbol(Ite.ProductionIndex, Ite.ElementIndex), Infos.GetAcceptableProductionIndexs(Ite.ProductionIndex, Ite.ElementIndex) };
 				SearchPropertyTemporary.push_back(Pro);
 			}
-			Node TemporaryNode;
 			for (std::size_t Index = 0; Index < SearchPropertyTemporary.size(); ++Index)
 			{
 				auto CurSearch = SearchPropertyTemporary[Index];
@@ -497,40 +515,13 @@ namespace Potato::SLRX
 					auto ProductionIndex = CurrentState[IndexIte2 - 1].ProductionIndex;
 					auto& ProduceRef = Infos.ProductionDescs[ProductionIndex];
 					TemporaryNode.Reduces.push_back(
-						Reduce{ ProduceRef.Symbol, ProductionIndex, ProduceRef.Elements.size(), ProduceRef.ProductionMask }
+						Reduce{ ProduceRef.Symbol, ProductionIndex, ProduceRef.Elements.size(), ProduceRef.ProductionMask, ProduceRef.ReduceType }
 					);
 				}
 			}
 
-			for (auto& Ite : Mappings)
-			{
-				std::optional<std::size_t> FindState;
-				std::span<ProductionInfo::SearchElement> Ref = std::span(Ite.Status.data(), Ite.Status.size());
-				for (std::size_t Index = 0; Index < PreNode.size(); ++Index)
-				{
-					auto Cur = PreNode[Index].Slice(Status);
-					if (Ref.size() == Cur.size() && std::equal(Cur.begin(), Cur.end(), Ref.begin(), Ref.end(), [](auto const& I1, auto const I2) { return I1 == I2; }))
-					{
-						FindState = Index;
-						break;
-					}
-				}
-				if (!FindState.has_value())
-				{
-					Misc::IndexSpan<> NewIndex{ Status.size(), Status.size() + Ite.Status.size() };
-					Status.insert(Status.end(), Ite.Status.begin(), Ite.Status.end());
-					FindState = PreNode.size();
-					PreNode.push_back(NewIndex);
-				}
-				auto AcceptablPISpan = Ite.AcceptableProductionIndex.Slice(AccepatbelProductionIndexs);
-				std::vector<std::size_t> TempAcce(AcceptablPISpan.begin(), AcceptablPISpan.end());
-				TemporaryNode.Shifts.push_back(
-					ShiftEdge{ Ite.Symbol, *FindState, Ite.ReserveStorage, std::move(TempAcce) }
-				);
-			}
-			auto CurStatusElementSpan = PreNode[SearchIte].Slice(Status);
 
-			for (auto& Ite : CurStatusElementSpan)
+			for (auto& Ite : CurrentState)
 			{
 				auto FindIte = std::find_if(TemporaryNode.MappedProduction.begin(), TemporaryNode.MappedProduction.end(),
 					[Ite](MappedProduction const& Finded) -> bool {
@@ -548,8 +539,48 @@ namespace Potato::SLRX
 					FindIte->DetectedPoint.push_back(Ite.ElementIndex);
 				}
 			}
+		};
+
+		auto InternStatus = [&](std::vector<ProductionInfo::SearchElement> const& Ref) -> std::size_t
+		{
+			auto [Ite, Bool] = StatusMapping.insert({ Ref, PreNode.size() });
+			if (Bool)
+			{
+				PreNode.push_back({ Status.size(), Status.size() + Ref.size() });
+				Status.insert(Status.end(), Ref.begin(), Ref.end());
+			}
+			return Ite->second;
+		};
+
+		// breadth first as the serial search, the states of one frontier are expanded in parallel and interned in order,
+		// so the node index does not depend on ThreadCount
+		std::vector<ExpandResult> Results;
+
+		for (std::size_t FrontierBegin = 0; FrontierBegin < PreNode.size();)
+		{
+			std::size_t FrontierEnd = PreNode.size();
+			Results.clear();
+			Results.resize(FrontierEnd - FrontierBegin);
+
+			Misc::ParallelFor(Results.size(), ThreadCount, ParallelTaskPerThread, [&](std::size_t Index) {
+				ExpandNode(PreNode[FrontierBegin + Index].Slice(std::span(std::as_const(Status).data(), Status.size())), Results[Index]);
+			});
+
+			for (auto& Ite : Results)
+			{
+				for (auto& Ite2 : Ite.Mappings)
+				{
+					auto ToNode = InternStatus(Ite2.Status);
+					auto AcceptablPISpan = Ite2.AcceptableProductionIndex.Slice(Ite.AccepatbelProductionIndexs);
+					std::vector<std::size_t> TempAcce(AcceptablPISpan.begin(), AcceptablPISpan.end());
+					Ite.TemporaryNode.Shifts.push_back(
+						ShiftEdge{ Ite2.Symbol, ToNode, Ite2.ReserveStorage, std::move(TempAcce) }
+					);
+				}
+				Nodes.push_back(std::move(Ite.TemporaryNode));
+			}
 
-			Nodes.push_back(std::move(TemporaryNode));
+			FrontierBegin = FrontierEnd;
 		}
 
 		return {std::move(Nodes)};
@@ -622,7 +653,7 @@ namespace Potato::SLRX
 		return Result;
 	}
 
-	LRX LRX::Create(LR0 const& Table, std::size_t MaxForwardDetect)
+	LRX LRX::Create(LR0 const& Table, std::size_t MaxForwardDetect, std::size_t ThreadCount)
 	{
 		std::vector<Node> Nodes;
 		std::vector<FastNode> TempNode;
@@ -652,10 +683,12 @@ namespace Potato::SLRX
 				std::size_t FastForwardShift;
 			};
 
-			std::vector<SearchCore> SearchRecord;
-
-			for (std::size_t Index = 1; Index < Table.Nodes.size(); ++Index)
+			// every node only writes its own TempNode
+			Misc::ParallelFor(Table.Nodes.size() - 1, ThreadCount, ParallelTaskPerThread, [&](std::size_t NodeIndex)
 			{
+				std::size_t Index = NodeIndex + 1;
+				std::vector<SearchCore> SearchRecord;
+
 				auto& Ref = Table.Nodes[Index];
 				auto& TempRef = TempNode[Index];
 
@@ -725,7 +758,7 @@ namespace Potato::SLRX
 						}
 					}
 				}
-			}
+			});
 		}
 
 #ifdef _DEBUG
@@ -800,10 +833,10 @@ namespace Potato::SLRX
 			}
 		}
 
-		while (!ConfligNode.empty())
+		// every conflict node only writes its own Nodes, taken in the same reverse order as the serial search
+		Misc::ParallelFor(ConfligNode.size(), ThreadCount, ParallelTaskPerThread, [&](std::size_t ConfligIndex)
 		{
-			auto ConfligNodeIte = *ConfligNode.rbegin();
-			ConfligNode.pop_back();
+			auto ConfligNodeIte = ConfligNode[ConfligNode.size() - ConfligIndex - 1];
 
 			struct DetecedElement
 			{
@@ -1147,7 +1180,7 @@ namespace Potato::SLRX
 					}
 				}
 			}
-		}
+		});
 		return LRX{std::move(Nodes)};
 	}
 
@@ -1255,6 +1288,7 @@ namespace Potato::SLRX
 			for (auto& Ite2 : Ite.Reduces)
 			{
 				ZipReducePropertyT Pro;
+				Pro.ReduceType = static_cast<HalfStandardT>(Ite2.Property.Reduce.reduce_type);
 				Misc::CrossTypeSetThrow<OutOfRange>(Pro.Mask, Ite2.Property.Reduce.mask, OutOfRange::TypeT::Mask, Ite2.Property.Reduce.mask);
 				Misc::CrossTypeSetThrow<OutOfRange>(Pro.NoTerminalValue, Ite2.Property.ReduceSymbol.symbol, OutOfRange::TypeT::SymbolValue, Ite2.Property.ReduceSymbol.symbol);
 				Misc::CrossTypeSetThrow<OutOfRange>(Pro.ProductionIndex, Ite2.Property.Reduce.production_index, OutOfRange::TypeT::ReduceProperty, Ite2.Property.Reduce.production_index);
@@ -1344,241 +1378,564 @@ namespace Potato::SLRX
 		return Re;
 	}
 
-	void LRXProcessor::SetObserverTable(LRX const& Table, LRX::ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function) 
+	auto LRXBinaryTableWrapper::CreateContainer(LRX const& Le) -> std::vector<StandardT>
 	{
-		assert(reduce_function);
-		TableWrapper = std::reference_wrapper<LRX const>{Table};
-		this->reduce_function = reduce_function;
-		this->suggest_function = suggest_function;
-		Clear();
+		return Misc::BinaryTableContainer::Create(ContainerTag, ContainerVersion, Create(Le));
 	}
 
-	void LRXProcessor::SetObserverTable(LRXBinaryTableWrapper Table, LRX::ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function) {
-		assert(reduce_function);
-		TableWrapper = Table;
-		this->reduce_function = reduce_function;
-		this->suggest_function = suggest_function;
-		Clear();
+	auto LRXBinaryTableWrapper::FromContainer(std::span<StandardT const> Buffer, bool VerifyChecksum) -> std::optional<LRXBinaryTableWrapper>
+	{
+		if (Misc::BinaryTableContainer::Check(Buffer, ContainerTag, ContainerVersion, VerifyChecksum) != Misc::BinaryTableContainer::CheckResultE::Ok)
+			return std::nullopt;
+		return LRXBinaryTableWrapper{ Misc::BinaryTableContainer::GetTable(Buffer) };
 	}
 
-	bool LRXProcessor::Consume(Symbol Value, Misc::IndexSpan<> TokenIndex, std::any AppendData)
+	// First fit row displacement, Rows[I] is the (Column, Value) list of row I.
+	// Return the base of each row, Check[Base[I] + Column] == I when the cell exists.
+	struct DisplacementResult
 	{
-		assert(!std::holds_alternative<std::monostate>(TableWrapper));
-		assert(reduce_function);
-		assert(Value.IsTerminal());
-		assert(States.rbegin()->TableState == CurrentTopState);
-
-		std::optional<TableConsumeResult> Result;
-		
-		if(std::holds_alternative<std::reference_wrapper<LRX const>>(TableWrapper))
-			Result = std::get<std::reference_wrapper<LRX const>>(TableWrapper).get().TableConsume(Value, *this, suggest_function);
-		else
-			Result = std::get<LRXBinaryTableWrapper>(TableWrapper).TableConsume(Value, *this, suggest_function);
+		std::vector<std::size_t> Base;
+		std::vector<std::size_t> Check;
+		std::vector<std::size_t> Value;
+	};
 
-		if (Result.has_value())
+	DisplacementResult RowDisplacement(std::span<std::vector<std::tuple<std::size_t, std::size_t>> const> Rows, std::size_t ColumnCount, std::size_t NoRow)
+	{
+		DisplacementResult Result;
+		Result.Base.resize(Rows.size(), 0);
+
+		// the dense rows are placed first, they are the hardest to fit.
+		std::vector<std::size_t> Order;
+		Order.reserve(Rows.size());
+		for (std::size_t I = 0; I < Rows.size(); ++I)
+			Order.push_back(I);
+		std::stable_sort(Order.begin(), Order.end(), [&](std::size_t I1, std::size_t I2) {
+			return Rows[I1].size() > Rows[I2].size();
+		});
+
+		std::size_t FirstFree = 0;
+		std::size_t MaxBase = 0;
+
+		for (auto Ite : Order)
 		{
-			CacheSymbols.push_back(ProcessElement{ Result->State, SymbolInfo{Value, TokenIndex}, {}, std::move(AppendData) });
-			std::size_t SymbolsIndex = 0;
-			while (SymbolsIndex <= CacheSymbols.size())
+			auto& Row = Rows[Ite];
+			if (Row.empty())
+				continue;
+
+			std::size_t MinColumn = std::get<0>(Row[0]);
+			for (auto& Ite2 : Row)
+				MinColumn = std::min(MinColumn, std::get<0>(Ite2));
+
+			std::size_t Base = (FirstFree > MinColumn) ? FirstFree - MinColumn : 0;
+			while (true)
 			{
-				if (Result->Reduce.has_value())
+				bool Fit = true;
+				for (auto& Ite2 : Row)
 				{
-					Misc::IndexSpan<> Cur;
-					auto Productions = std::span(States.data(), States.size()).subspan(States.size() - Result->Reduce->Reduce.element_count);
-					for (auto& Ite : Productions)
+					auto Index = Base + std::get<0>(Ite2);
+					if (Index < Result.Check.size() && Result.Check[Index] != NoRow)
 					{
-						if (Ite.Value.TokenIndex.Size() != 0)
-						{
-							if (Cur.Size() == 0)
-							{
-								Cur = Ite.Value.TokenIndex;
-							}
-							else {
-								Cur = Cur.Expand(Ite.Value.TokenIndex);
-							}
-						}
+						Fit = false;
+						break;
 					}
+				}
+				if (Fit)
+					break;
+				++Base;
+			}
 
-					SymbolInfo SElement{
-						Result->Reduce->ReduceSymbol,
-						Cur
-					};
+			if (Result.Check.size() < Base + ColumnCount)
+			{
+				Result.Check.resize(Base + ColumnCount, NoRow);
+				Result.Value.resize(Base + ColumnCount, 0);
+			}
 
-					ReduceInfo Desc{
-						Result->Reduce->Reduce.element_count,
-						Result->Reduce->Reduce.production_index,
-						Result->Reduce->Reduce.mask
-					};
+			for (auto& Ite2 : Row)
+			{
+				Result.Check[Base + std::get<0>(Ite2)] = Ite;
+				Result.Value[Base + std::get<0>(Ite2)] = std::get<1>(Ite2);
+			}
 
-					ReduceProduction Pro{
-						Desc,
-						Productions
-					};
+			Result.Base[Ite] = Base;
+			MaxBase = std::max(MaxBase, Base);
 
-					auto AppendData = reduce_function(SElement, Pro);
+			while (FirstFree < Result.Check.size() && Result.Check[FirstFree] != NoRow)
+				++FirstFree;
+		}
 
-					States.resize(States.size() - Result->Reduce->Reduce.element_count);
-					States.push_back(
-						ProcessElement{
-							Result->State,
-							SElement,
-							Desc,
-							std::move(AppendData)
-						}
-					);
-					RequireNode = Result->RequireNode;
-					CurrentTopState = Result->State;
-					SymbolsIndex = 0;
-					TryReduce();
-				}
-				else {
-					if (Result->RequireNode == 0)
+		// every Base + Column with Column < ColumnCount stays inside the array.
+		Result.Check.resize(std::max(Result.Check.size(), MaxBase + ColumnCount), NoRow);
+		Result.Value.resize(Result.Check.size(), 0);
+		return Result;
+	}
+
+	void LRXCompressedTableWrapper::Serilize(Misc::StructedSerilizerWritter<StandardT>& Writter, LRX const& Ref)
+	{
+		auto OldMark = Writter.PushMark();
+
+		auto GetColumn = [](Symbol Value) -> std::size_t {
+			return Value.IsEndOfFile() ? 0 : Value.symbol + 1;
+		};
+
+		std::vector<ZipNodeT> Nodes;
+		Nodes.reserve(Ref.Nodes.size());
+
+		std::vector<std::size_t> ReduceOffset;
+		ReduceOffset.reserve(Ref.Nodes.size());
+
+		std::vector<std::vector<std::tuple<std::size_t, std::size_t>>> ActionRows;
+		std::size_t ColumnCount = 1;
+		std::size_t ReduceCount = 0;
+
+		for (auto& Ite : Ref.Nodes)
+		{
+			ReduceOffset.push_back(ReduceCount);
+			ReduceCount += Ite.Reduces.size();
+		}
+
+		for (std::size_t NodeIndex = 0; NodeIndex < Ref.Nodes.size(); ++NodeIndex)
+		{
+			auto& Ite = Ref.Nodes[NodeIndex];
+
+			ZipNodeT NewNode;
+			Misc::CrossTypeSetThrow<OutOfRange>(NewNode.FirstRow, ActionRows.size(), OutOfRange::TypeT::RequireNodeCount, ActionRows.size());
+			if (Ite.RequireNodes.empty() && Ite.Reduces.size() == 1)
+				Misc::CrossTypeSetThrow<OutOfRange>(NewNode.DefaultReduce, ReduceOffset[NodeIndex], OutOfRange::TypeT::ReduceCount, ReduceOffset[NodeIndex]);
+			Nodes.push_back(NewNode);
+
+			for (auto& Ite2 : Ite.RequireNodes)
+			{
+				std::vector<std::tuple<std::size_t, std::size_t>> Row;
+				Row.reserve(Ite2.size());
+				for (auto& Ite3 : Ite2)
+				{
+					std::size_t Column = GetColumn(Ite3.RequireSymbol);
+					ColumnCount = std::max(ColumnCount, Column + 1);
+					ActionE Action = ActionE::Error;
+					std::size_t Payload = Ite3.ReferenceIndex;
+					switch (Ite3.Type)
 					{
-						auto LastSymbol = std::move(*CacheSymbols.begin());
-						auto LastSymbolValue = LastSymbol.Value;
-						CacheSymbols.pop_front();
-						LastSymbol.TableState = Result->State;
-						States.push_back(std::move(LastSymbol));
-						RequireNode = Result->RequireNode;
-						CurrentTopState = Result->State;
-						SymbolsIndex = 0;
-						if (LastSymbolValue.Value != Symbol::EndOfFile())
-						{
-							TryReduce();
-						}
-						else {
-							assert(CacheSymbols.empty());
-							assert(States.size() == 3);
-						}
-					}
-					else {
-						RequireNode = Result->RequireNode;
-						return true;
+					case LRX::RequireNodeType::SymbolValue:
+						Action = ActionE::RequireNode;
+						break;
+					case LRX::RequireNodeType::NeedPredictShiftProperty:
+					case LRX::RequireNodeType::ShiftProperty:
+						Action = ActionE::Shift;
+						break;
+					case LRX::RequireNodeType::ReduceProperty:
+						Action = ActionE::Reduce;
+						Payload += ReduceOffset[NodeIndex];
+						break;
+					default:
+						assert(false);
+						break;
 					}
+					Row.push_back({ Column, (Payload << ActionBits) | static_cast<std::size_t>(Action) });
 				}
-				if (!CacheSymbols.empty())
-				{
-					if (std::holds_alternative<std::reference_wrapper<LRX const>>(TableWrapper))
-						Result = std::get<std::reference_wrapper<LRX const>>(TableWrapper).get().TableConsume(CacheSymbols[SymbolsIndex].Value.Value, *this, suggest_function);
-					else
-						Result = std::get<LRXBinaryTableWrapper>(TableWrapper).TableConsume(CacheSymbols[SymbolsIndex].Value.Value, *this, suggest_function);
-					++SymbolsIndex;
-					assert(Result.has_value());
-				}
-				else {
-					return true;
-				}
+				ActionRows.push_back(std::move(Row));
 			}
-			return true;
 		}
-		else {
-			return false;
+
+		std::vector<ZipReduceT> Reduces;
+		Reduces.reserve(ReduceCount);
+		std::vector<std::vector<std::tuple<std::size_t, std::size_t>>> GotoRows;
+		std::map<std::vector<std::tuple<std::size_t, std::size_t>>, std::size_t> GotoRowMapping;
+
+		for (auto& Ite : Ref.Nodes)
+		{
+			for (auto& Ite2 : Ite.Reduces)
+			{
+				ZipReduceT Pro;
+				Pro.ReduceType = static_cast<StandardT>(Ite2.Property.Reduce.reduce_type);
+				Misc::CrossTypeSetThrow<OutOfRange>(Pro.Mask, Ite2.Property.Reduce.mask, OutOfRange::TypeT::Mask, Ite2.Property.Reduce.mask);
+				Misc::CrossTypeSetThrow<OutOfRange>(Pro.NoTerminalValue, Ite2.Property.ReduceSymbol.symbol, OutOfRange::TypeT::SymbolValue, Ite2.Property.ReduceSymbol.symbol);
+				Misc::CrossTypeSetThrow<OutOfRange>(Pro.ProductionIndex, Ite2.Property.Reduce.production_index, OutOfRange::TypeT::ReduceProperty, Ite2.Property.Reduce.production_index);
+				Misc::CrossTypeSetThrow<OutOfRange>(Pro.ProductionCount, Ite2.Property.Reduce.element_count, OutOfRange::TypeT::ReduceProperty, Ite2.Property.Reduce.element_count);
+
+				std::vector<std::tuple<std::size_t, std::size_t>> Row;
+				Row.reserve(Ite2.Tuples.size());
+				for (auto& Ite3 : Ite2.Tuples)
+					Row.push_back({ Ite3.LastState, Ite3.TargetState });
+				std::sort(Row.begin(), Row.end());
+				auto [MIte, B] = GotoRowMapping.insert({ Row, GotoRows.size() });
+				if (B)
+					GotoRows.push_back(std::move(Row));
+				Misc::CrossTypeSetThrow<OutOfRange>(Pro.GotoRow, MIte->second, OutOfRange::TypeT::ReduceCount, MIte->second);
+				Reduces.push_back(Pro);
+			}
 		}
+
+		auto Action = RowDisplacement(std::span(ActionRows), ColumnCount, NoRow);
+		auto Goto = RowDisplacement(std::span(GotoRows), Ref.Nodes.size(), NoRow);
+
+		auto WriteArray = [&](std::vector<std::size_t> const& Source, OutOfRange::TypeT Type) {
+			std::vector<StandardT> Temp;
+			Temp.resize(Source.size());
+			for (std::size_t I = 0; I < Source.size(); ++I)
+			{
+				if (Source[I] == NoRow)
+					Temp[I] = NoRow;
+				else
+					Misc::CrossTypeSetThrow<OutOfRange>(Temp[I], Source[I], Type, Source[I]);
+			}
+			Writter.WriteObjectArray(std::span(Temp));
+		};
+
+		ZipHeadT Head;
+		Misc::CrossTypeSetThrow<OutOfRange>(Head.NodeCount, Ref.Nodes.size(), OutOfRange::TypeT::NodeCount, Ref.Nodes.size());
+		Head.StartupNode = static_cast<StandardT>(LRX::StartupNodeIndex());
+		Misc::CrossTypeSetThrow<OutOfRange>(Head.ColumnCount, ColumnCount, OutOfRange::TypeT::SymbolValue, ColumnCount);
+		Misc::CrossTypeSetThrow<OutOfRange>(Head.RowCount, ActionRows.size(), OutOfRange::TypeT::RequireNodeCount, ActionRows.size());
+		Misc::CrossTypeSetThrow<OutOfRange>(Head.ActionSize, Action.Check.size(), OutOfRange::TypeT::RequireNodeOffset, Action.Check.size());
+		Misc::CrossTypeSetThrow<OutOfRange>(Head.ReduceCount, Reduces.size(), OutOfRange::TypeT::ReduceCount, Reduces.size());
+		Misc::CrossTypeSetThrow<OutOfRange>(Head.GotoRowCount, GotoRows.size(), OutOfRange::TypeT::ReduceCount, GotoRows.size());
+		Misc::CrossTypeSetThrow<OutOfRange>(Head.GotoSize, Goto.Check.size(), OutOfRange::TypeT::NodeOffset, Goto.Check.size());
+
+		Writter.WriteObject(Head);
+		Writter.WriteObjectArray(std::span(Nodes));
+		WriteArray(Action.Base, OutOfRange::TypeT::RequireNodeOffset);
+		WriteArray(Action.Check, OutOfRange::TypeT::RequireNodeOffset);
+		WriteArray(Action.Value, OutOfRange::TypeT::RequireNodeOffset);
+		Writter.WriteObjectArray(std::span(Reduces));
+		WriteArray(Goto.Base, OutOfRange::TypeT::NodeOffset);
+		WriteArray(Goto.Check, OutOfRange::TypeT::NodeOffset);
+		WriteArray(Goto.Value, OutOfRange::TypeT::NodeOffset);
+
+		Writter.PopMark(OldMark);
 	}
 
-	void LRXProcessor::Clear()
+	auto LRXCompressedTableWrapper::Create(LRX const& Le) -> std::vector<StandardT>
+	{
+		Misc::StructedSerilizerWritter<StandardT> Predict;
+
+		Serilize(Predict, Le);
+		std::vector<StandardT> Re;
+		Re.resize(Predict.GetWritedSize());
+		auto Span = std::span(Re.data(), Re.size());
+		Misc::StructedSerilizerWritter<StandardT> Writter{ Span };
+		Serilize(Writter, Le);
+
+		return Re;
+	}
+
+	auto LRXCompressedTableWrapper::CreateContainer(LRX const& Le) -> std::vector<StandardT>
+	{
+		return Misc::BinaryTableContainer::Create(ContainerTag, ContainerVersion, Create(Le));
+	}
+
+	auto LRXCompressedTableWrapper::FromContainer(std::span<StandardT const> Buffer, bool VerifyChecksum) -> std::optional<LRXCompressedTableWrapper>
+	{
+		if (Misc::BinaryTableContainer::Check(Buffer, ContainerTag, ContainerVersion, VerifyChecksum) != Misc::BinaryTableContainer::CheckResultE::Ok)
+			return std::nullopt;
+		return LRXCompressedTableWrapper{ Misc::BinaryTableContainer::GetTable(Buffer) };
+	}
+
+	LRXCompressedTableWrapper::LRXCompressedTableWrapper(std::span<StandardT const> InputBuffer)
+		: Buffer(InputBuffer)
+	{
+		Misc::StructedSerilizerReader<StandardT const> Reader(Buffer);
+		auto Head = Reader.ReadObject<ZipHeadT>();
+		StartupNode = Head->StartupNode;
+		ColumnCount = Head->ColumnCount;
+		Nodes = Reader.ReadObjectArray<ZipNodeT>(Head->NodeCount);
+		ActionBase = Reader.ReadObjectArray<StandardT>(Head->RowCount);
+		ActionCheck = Reader.ReadObjectArray<StandardT>(Head->ActionSize);
+		ActionValue = Reader.ReadObjectArray<StandardT>(Head->ActionSize);
+		Reduces = Reader.ReadObjectArray<ZipReduceT>(Head->ReduceCount);
+		GotoBase = Reader.ReadObjectArray<StandardT>(Head->GotoRowCount);
+		GotoCheck = Reader.ReadObjectArray<StandardT>(Head->GotoSize);
+		GotoValue = Reader.ReadObjectArray<StandardT>(Head->GotoSize);
+	}
+
+	LR0::Reduce LRXCompressedTableWrapper::GetReduce(std::size_t ReduceIndex) const
+	{
+		assert(ReduceIndex < Reduces.size());
+		auto& Ref = Reduces[ReduceIndex];
+		LR0::Reduce Reduce;
+		Reduce.ReduceSymbol = Symbol::AsNoTerminal(Ref.NoTerminalValue);
+		Reduce.Reduce.mask = Ref.Mask;
+		Reduce.Reduce.production_index = Ref.ProductionIndex;
+		Reduce.Reduce.element_count = Ref.ProductionCount;
+		Reduce.Reduce.reduce_type = static_cast<ReduceTypeE>(Ref.ReduceType);
+		return Reduce;
+	}
+
+	std::size_t LRXCompressedTableWrapper::Goto(std::size_t ReduceIndex, std::size_t LastState) const
+	{
+		auto GotoRow = Reduces[ReduceIndex].GotoRow;
+		auto Index = GotoBase[GotoRow] + LastState;
+		assert(Index < GotoCheck.size() && GotoCheck[Index] == GotoRow);
+		return GotoValue[Index];
+	}
+
+	void LRXStateContext::SetTable(TableWrapperT Table, LRX::SuggestSymbolFunctionT suggest_function)
+	{
+		assert(!std::holds_alternative<std::monostate>(Table));
+		TableWrapper = std::move(Table);
+		this->suggest_function = suggest_function;
+	}
+
+	std::optional<TableConsumeResult> LRXStateContext::TableConsume(Symbol Value) const
+	{
+		auto Suggest = Recovering ? LRX::SuggestSymbolFunctionT{} : suggest_function;
+		if (std::holds_alternative<std::reference_wrapper<LRX const>>(TableWrapper))
+			return std::get<std::reference_wrapper<LRX const>>(TableWrapper).get().TableConsume(Value, *this, Suggest);
+		else if (std::holds_alternative<LRXBinaryTableWrapper>(TableWrapper))
+			return std::get<LRXBinaryTableWrapper>(TableWrapper).TableConsume(Value, *this, Suggest);
+		else
+			return std::get<LRXCompressedTableWrapper>(TableWrapper).TableConsume(Value, *this, Suggest);
+	}
+
+	std::optional<TableReduceResult> LRXStateContext::TableReduce() const
+	{
+		if (std::holds_alternative<std::reference_wrapper<LRX const>>(TableWrapper))
+			return std::get<std::reference_wrapper<LRX const>>(TableWrapper).get().TableReduce(*this);
+		else if (std::holds_alternative<LRXBinaryTableWrapper>(TableWrapper))
+			return std::get<LRXBinaryTableWrapper>(TableWrapper).TableReduce(*this);
+		else
+			return std::get<LRXCompressedTableWrapper>(TableWrapper).TableReduce(*this);
+	}
+
+	void LRXStateContext::SetRecovery(ErrorFunctionT error_function, std::optional<Symbol> ErrorSymbol, std::span<Symbol const> SyncSymbols)
+	{
+		assert(!ErrorSymbol.has_value() || ErrorSymbol->IsTerminal());
+		this->error_function = error_function;
+		this->ErrorSymbol = ErrorSymbol;
+		this->SyncSymbols.assign(SyncSymbols.begin(), SyncSymbols.end());
+	}
+
+	void LRXStateContext::ResetState()
 	{
 		assert(!std::holds_alternative<std::monostate>(TableWrapper));
-		assert(reduce_function);
-		CacheSymbols.clear();
+		CacheSymbols.Clear();
 		States.clear();
 		std::size_t StartupIndex = 0;
 		if (std::holds_alternative<std::reference_wrapper<LRX const>>(TableWrapper))
 			StartupIndex = std::get<std::reference_wrapper<LRX const>>(TableWrapper).get().StartupNodeIndex();
-		else
+		else if (std::holds_alternative<LRXBinaryTableWrapper>(TableWrapper))
 			StartupIndex = std::get<LRXBinaryTableWrapper>(TableWrapper).StartupNodeIndex();
+		else
+			StartupIndex = std::get<LRXCompressedTableWrapper>(TableWrapper).StartupNodeIndex();
 		CurrentTopState = StartupIndex;
-		States.push_back({ CurrentTopState, {}, {}, {}});
+		States.push_back({ CurrentTopState, {} });
 		RequireNode = 0;
-		TryReduce();
+		ConsumedCount = 0;
+		TokenEnd = 0;
+		ErrorCount = 0;
+		Recovering = false;
 	}
 
-	bool LRXProcessor::EndOfFile()
+	void LRXStateContext::SaveState(LRXStateSnapshot& Output) const
 	{
-		auto Re = Consume(Symbol::EndOfFile(), {}, {});
-		if (Re)
+		Output.ConsumedCount = ConsumedCount;
+		Output.TokenEnd = TokenEnd;
+		Output.CurrentTopState = CurrentTopState;
+		Output.RequireNode = RequireNode;
+		Output.ErrorCount = ErrorCount;
+		Output.Recovering = Recovering;
+		Output.CacheSymbols.clear();
+		for (std::size_t Index = 0; Index < CacheSymbols.Size(); ++Index)
+			Output.CacheSymbols.push_back(CacheSymbols[Index]);
+	}
+
+	void LRXStateContext::LoadState(LRXStateSnapshot const& Input)
+	{
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		ConsumedCount = Input.ConsumedCount;
+		TokenEnd = Input.TokenEnd;
+		CurrentTopState = Input.CurrentTopState;
+		RequireNode = Input.RequireNode;
+		ErrorCount = Input.ErrorCount;
+		Recovering = Input.Recovering;
+		States.clear();
+		CacheSymbols.Clear();
+		for (auto& Ite : Input.CacheSymbols)
+			CacheSymbols.PushBack(Ite);
+	}
+
+	void LRXProcessor::SetObserverTable(LRX const& Table, LRX::ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function) 
+	{
+		assert(reduce_function);
+		this->reduce_function = reduce_function;
+		SetTable(std::reference_wrapper<LRX const>{Table}, suggest_function);
+		Clear();
+	}
+
+	void LRXProcessor::SetObserverTable(LRXBinaryTableWrapper Table, LRX::ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function) {
+		assert(reduce_function);
+		this->reduce_function = reduce_function;
+		SetTable(Table, suggest_function);
+		Clear();
+	}
+
+	void LRXProcessor::SetObserverTable(LRXCompressedTableWrapper Table, LRX::ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function) {
+		assert(reduce_function);
+		this->reduce_function = reduce_function;
+		SetTable(Table, suggest_function);
+		Clear();
+	}
+
+	bool LRXProcessor::Consume(Symbol Value, Misc::IndexSpan<> TokenIndex, std::any AppendData)
+	{
+		assert(reduce_function);
+		CacheDatas.PushBack(std::move(AppendData));
+		if (ConsumeSymbol(Value, TokenIndex))
 		{
-			assert(States.size() == 3);
+			if (SnapshotInterval != 0 && Value != Symbol::EndOfFile() && ConsumedCount % SnapshotInterval == 0)
+			{
+				Snapshot Cur;
+				SaveState(Cur);
+				if (!Snapshots.empty())
+				{
+					Cur.TopElement = Snapshots.rbegin()->TopElement;
+					Cur.ElementCount = Snapshots.rbegin()->ElementCount;
+				}
+				while (Cur.ElementCount > UnchangedElementCount)
+				{
+					Cur.TopElement = Cur.TopElement->Prev;
+					--Cur.ElementCount;
+				}
+				for (; Cur.ElementCount < Elements.size(); ++Cur.ElementCount)
+					Cur.TopElement = std::make_shared<SnapshotElement>(Elements[Cur.ElementCount], std::move(Cur.TopElement));
+				UnchangedElementCount = Elements.size();
+				for (std::size_t Index = 0; Index < CacheDatas.Size(); ++Index)
+					Cur.CacheDatas.push_back(CacheDatas[Index]);
+				Snapshots.push_back(std::move(Cur));
+			}
 			return true;
 		}
+		CacheDatas.PopBack();
 		return false;
 	}
 
-	std::any& LRXProcessor::GetDataRaw()
+	std::size_t LRXProcessor::RestoreBefore(std::size_t EditBegin)
 	{
-		assert(States.size() == 3);
-		return States[1].AppendData;
+		std::size_t Count = Snapshots.size();
+		while (Count > 0 && Snapshots[Count - 1].TokenEnd > EditBegin)
+			--Count;
+		return RestoreSnapshot(Count);
 	}
 
-	void LRXProcessor::TryReduce()
+	std::size_t LRXProcessor::RestoreSnapshot(std::size_t SnapshotCount)
 	{
-		assert(!std::holds_alternative<std::monostate>(TableWrapper));
-		assert(reduce_function);
-		if (RequireNode == 0)
+		assert(SnapshotCount <= Snapshots.size());
+		Snapshots.resize(SnapshotCount);
+
+		if (Snapshots.empty())
 		{
-			while (true)
+			Clear();
+			return 0;
+		}
+
+		auto& Ref = *Snapshots.rbegin();
+		LoadState(Ref);
+		Elements.resize(Ref.ElementCount);
+		std::size_t Index = Ref.ElementCount;
+		for (auto Ite = Ref.TopElement.get(); Ite != nullptr; Ite = Ite->Prev.get())
+			Elements[--Index] = Ite->Element;
+		assert(Index == 0);
+		// every element is pushed with the state which it is shifted or reduced to, so they are the state stack
+		for (auto& Ite : Elements)
+			States.push_back({ Ite.TableState, Ite.Value });
+		assert(!States.empty() && States.rbegin()->TableState == CurrentTopState);
+		UnchangedElementCount = Elements.size();
+		CacheDatas.Clear();
+		for (auto& Ite : Ref.CacheDatas)
+			CacheDatas.PushBack(Ite);
+		return ConsumedCount;
+	}
+
+	void LRXProcessor::ShiftValue(LRXStateElement const& Element)
+	{
+		Elements.push_back(ProcessElement{ Element.TableState, Element.Value, {}, CacheDatas.PopFront() });
+	}
+
+	std::vector<std::any> CollectList(Symbol ListSymbol, std::span<ProcessElement> Productions)
+	{
+		std::vector<std::any> List;
+		for (auto& Ite : Productions)
+		{
+			if (Ite.Value.Value == ListSymbol && Ite.Reduce.has_value() && Ite.Reduce->ReduceType == ReduceTypeE::CollectList)
 			{
-				std::optional<TableReduceResult> Result;
-				if (std::holds_alternative<std::reference_wrapper<LRX const>>(TableWrapper))
-					Result = std::get<std::reference_wrapper<LRX const>>(TableWrapper).get().TableReduce(*this);
+				auto& SubList = std::any_cast<std::vector<std::any>&>(Ite.AppendData);
+				if (List.empty())
+					List = std::move(SubList);
 				else
-					Result = std::get<LRXBinaryTableWrapper>(TableWrapper).TableReduce(*this);
-				if (Result.has_value())
-				{
-					Misc::IndexSpan<> Cur;
-					auto Productions = std::span(States.data(), States.size()).subspan(States.size() - Result->Reduce.Reduce.element_count);
-					for (auto& Ite : Productions)
-					{
-						if (Ite.Value.TokenIndex.Size() != 0)
-						{
-							if (Cur.Size() == 0)
-							{
-								Cur = Ite.Value.TokenIndex;
-							}
-							else {
-								Cur = Cur.Expand(Ite.Value.TokenIndex);
-							}
-						}
-					}
+					List.insert(List.end(), std::make_move_iterator(SubList.begin()), std::make_move_iterator(SubList.end()));
+			}
+			else if (Ite.AppendData.has_value())
+			{
+				List.push_back(std::move(Ite.AppendData));
+			}
+		}
+		return List;
+	}
 
-					SymbolInfo SElement{
-						Result->Reduce.ReduceSymbol,
-						Cur,
-					};
+	void LRXProcessor::ReduceValue(LRXStateElement const& Element, ReduceInfo Desc)
+	{
+		assert(Elements.size() >= Desc.ProductionCount);
 
-					ReduceInfo Desc{
-						Result->Reduce.Reduce.element_count,
-						Result->Reduce.Reduce.production_index,
-						Result->Reduce.Reduce.mask
-					};
+		auto Productions = std::span(Elements.data(), Elements.size()).subspan(Elements.size() - Desc.ProductionCount);
 
-					ReduceProduction Pro{
-						Desc,
-						Productions
-					};
+		std::any AppendData;
 
-					auto AppendData = reduce_function(SElement, Pro);
+		switch (Desc.ReduceType)
+		{
+		case ReduceTypeE::PassThrough:
+			assert(!Productions.empty());
+			AppendData = std::move(Productions[0].AppendData);
+			break;
+		case ReduceTypeE::CollectList:
+			AppendData = CollectList(Element.Value.Value, Productions);
+			break;
+		default:
+			AppendData = reduce_function(Element.Value, ReduceProduction{ Desc, Productions });
+			break;
+		}
 
-					States.resize(States.size() - Result->Reduce.Reduce.element_count);
-					States.push_back(
-						ProcessElement{
-							Result->State,
-							SElement,
-							Desc,
-							std::move(AppendData)
-						}
-					);
-					CurrentTopState = Result->State;
-				}
-				else {
-					break;
-				}
+		Elements.resize(Elements.size() - Desc.ProductionCount);
+		UnchangedElementCount = std::min(UnchangedElementCount, Elements.size());
+		Elements.push_back(
+			ProcessElement{
+				Element.TableState,
+				Element.Value,
+				Desc,
+				std::move(AppendData)
 			}
+		);
+	}
+
+	void LRXProcessor::Clear()
+	{
+		assert(reduce_function);
+		ResetState();
+		CacheDatas.Clear();
+		Elements.clear();
+		Snapshots.clear();
+		UnchangedElementCount = 0;
+		Elements.push_back({ CurrentTopState, {}, {}, {} });
+		TryReduce();
+	}
+
+	bool LRXProcessor::EndOfFile()
+	{
+		auto Re = Consume(Symbol::EndOfFile(), {}, {});
+		if (Re)
+		{
+			assert(Elements.size() == 3);
+			return true;
 		}
+		return false;
 	}
 
+	std::any& LRXProcessor::GetDataRaw()
+	{
+		assert(Elements.size() == 3);
+		return Elements[1].AppendData;
+	}
 
-	std::optional<TableConsumeResult> LRX::TableConsume(Symbol Value, LRXProcessor const& Info, SuggestSymbolFunctionT suggest) const
+
+	std::optional<TableConsumeResult> LRX::TableConsume(Symbol Value, LRXStateContext const& Info, SuggestSymbolFunctionT suggest) const
 	{
 		assert(Value.IsTerminal());
 		assert(Nodes.size() > Info.CurrentTopState);
@@ -1644,7 +2001,7 @@ namespace Potato::SLRX
 		return {};
 	}
 
-	std::optional<TableReduceResult> LRX::TableReduce(LRXProcessor const& Info) const
+	std::optional<TableReduceResult> LRX::TableReduce(LRXStateContext const& Info) const
 	{
 		assert(Nodes.size() > Info.CurrentTopState);
 		auto& NodeRef = Nodes[Info.CurrentTopState];
@@ -1669,7 +2026,7 @@ namespace Potato::SLRX
 		return {};
 	}
 
-	auto LRXBinaryTableWrapper::TableConsume(Symbol Value, LRXProcessor const& Info, LRX::SuggestSymbolFunctionT suggest) const ->std::optional<TableConsumeResult>
+	auto LRXBinaryTableWrapper::TableConsume(Symbol Value, LRXStateContext const& Info, LRX::SuggestSymbolFunctionT suggest) const ->std::optional<TableConsumeResult>
 	{
 		assert(TotalBufferSize() > Info.CurrentTopState);
 		assert(Info.States.rbegin()->TableState == Info.CurrentTopState);
@@ -1723,6 +2080,7 @@ namespace Potato::SLRX
 						Reduce.Reduce.mask = ReduceP->Mask;
 						Reduce.Reduce.production_index = ReduceP->ProductionIndex;
 						Reduce.Reduce.element_count = ReduceP->ProductionCount;
+						Reduce.Reduce.reduce_type = static_cast<ReduceTypeE>(ReduceP->ReduceType);
 						Re.Reduce = Reduce;
 						assert(Info.States.size() > Re.Reduce->Reduce.element_count);
 						auto RefState = Info.States[Info.States.size() - Re.Reduce->Reduce.element_count - 1].TableState;
@@ -1758,7 +2116,7 @@ namespace Potato::SLRX
 		return {};
 	}
 
-	auto LRXBinaryTableWrapper::TableReduce(LRXProcessor const& Info) const -> std::optional<TableReduceResult>
+	auto LRXBinaryTableWrapper::TableReduce(LRXStateContext const& Info) const -> std::optional<TableReduceResult>
 	{
 		assert(TotalBufferSize() > Info.CurrentTopState);
 		assert(Info.States.rbegin()->TableState == Info.CurrentTopState);
@@ -1776,6 +2134,7 @@ namespace Potato::SLRX
 				Reduce.Reduce.mask = ReduceP->Mask;
 				Reduce.Reduce.production_index = ReduceP->ProductionIndex;
 				Reduce.Reduce.element_count = ReduceP->ProductionCount;
+				Reduce.Reduce.reduce_type = static_cast<ReduceTypeE>(ReduceP->ReduceType);
 				TableReduceResult Result;
 				Result.Reduce = Reduce;
 				assert(Info.States.size() > Reduce.Reduce.element_count);
@@ -1793,6 +2152,87 @@ namespace Potato::SLRX
 		return {};
 	}
 
+	auto LRXCompressedTableWrapper::TableConsume(Symbol Value, LRXStateContext const& Info, LRX::SuggestSymbolFunctionT suggest) const -> std::optional<TableConsumeResult>
+	{
+		assert(Value.IsTerminal());
+		assert(Nodes.size() > Info.CurrentTopState);
+		assert(Info.States.rbegin()->TableState == Info.CurrentTopState);
+
+		std::size_t Row = Nodes[Info.CurrentTopState].FirstRow + Info.RequireNode;
+		assert(Row < ActionBase.size());
+
+		std::size_t Column = Value.IsEndOfFile() ? 0 : Value.symbol + 1;
+
+		if (Column < ColumnCount)
+		{
+			auto Index = ActionBase[Row] + Column;
+			if (ActionCheck[Index] == Row)
+			{
+				auto Cell = ActionValue[Index];
+				std::size_t Payload = (Cell >> ActionBits);
+				switch (static_cast<ActionE>(Cell & ((StandardT(1) << ActionBits) - 1)))
+				{
+				case ActionE::RequireNode:
+				{
+					TableConsumeResult Re;
+					Re.State = Info.CurrentTopState;
+					Re.RequireNode = Payload;
+					return Re;
+				}
+				case ActionE::Shift:
+				{
+					TableConsumeResult Re;
+					Re.State = Payload;
+					Re.RequireNode = 0;
+					return Re;
+				}
+				case ActionE::Reduce:
+				{
+					TableConsumeResult Re;
+					Re.Reduce = GetReduce(Payload);
+					assert(Info.States.size() > Re.Reduce->Reduce.element_count);
+					auto RefState = Info.States[Info.States.size() - Re.Reduce->Reduce.element_count - 1].TableState;
+					Re.State = Goto(Payload, RefState);
+					Re.RequireNode = 0;
+					return Re;
+				}
+				default:
+					assert(false);
+					break;
+				}
+			}
+		}
+
+		if (suggest)
+		{
+			std::pmr::vector<Symbol> suggest_symbols;
+			for (std::size_t I = 0; I < ColumnCount; ++I)
+			{
+				if (ActionCheck[ActionBase[Row] + I] == Row)
+					suggest_symbols.emplace_back(I == 0 ? Symbol::EndOfFile() : Symbol::AsTerminal(I - 1));
+			}
+			suggest(std::span(suggest_symbols.data(), suggest_symbols.size()));
+		}
+		return {};
+	}
+
+	auto LRXCompressedTableWrapper::TableReduce(LRXStateContext const& Info) const -> std::optional<TableReduceResult>
+	{
+		assert(Nodes.size() > Info.CurrentTopState);
+		assert(Info.States.rbegin()->TableState == Info.CurrentTopState);
+		auto ReduceIndex = Nodes[Info.CurrentTopState].DefaultReduce;
+		if (ReduceIndex != NoReduce)
+		{
+			TableReduceResult Result;
+			Result.Reduce = GetReduce(ReduceIndex);
+			assert(Info.States.size() > Result.Reduce.Reduce.element_count);
+			auto RefState = Info.States[Info.States.size() - Result.Reduce.Reduce.element_count - 1].TableState;
+			Result.State = Goto(ReduceIndex, RefState);
+			return Result;
+		}
+		return {};
+	}
+
 	namespace Exception
 	{
 		char const* Interface::what() const {  return "PotatoDLrException"; };
@@ -1803,6 +2243,8 @@ namespace Potato::SLRX
 				return "PotatoSLRXException::WrongProduction::MaskNotFolloedNoterminalSymbol";
 			case Category::TerminalSymbolAsProductionBegin:
 				return "PotatoSLRXException::WrongProduction::TerminalSymbolAsProductionBegin";
+			case Category::PassThroughWithoutElement:
+				return "PotatoSLRXException::WrongProduction::PassThroughWithoutElement";
 			default:
 				return "PotatoSLRXException::WrongProduction::Unknow";
 			}
@@ -1,3 +1,7 @@
+module;
+
+#include <cassert>
+
 export module PotatoSLRX;
 
 import std;
@@ -33,6 +37,17 @@ export namespace Potato::SLRX
 		std::size_t symbol = 0;
 	};
 
+	// PassThrough and CollectList are reduced by the processor without calling the reduce function.
+	// PassThrough keeps the value of the first element.
+	// CollectList collects the non-empty values of the elements into a std::vector<std::any>, 
+	// a list of the same symbol made by CollectList is spliced. LRXValueProcessor still calls the reduce function for CollectList.
+	enum class ReduceTypeE
+	{
+		Callback = 0,
+		PassThrough,
+		CollectList,
+	};
+
 	struct ParsingStep
 	{
 		Symbol value;
@@ -42,6 +57,7 @@ export namespace Potato::SLRX
 			std::size_t production_index = 0;
 			std::size_t element_count = 0;
 			std::size_t mask = 0;
+			ReduceTypeE reduce_type = ReduceTypeE::Callback;
 		};
 
 		struct ShiftT
@@ -96,8 +112,8 @@ export namespace Potato::SLRX
 
 	struct ProductionBuilder
 	{
-		ProductionBuilder(Symbol ProductionValue, std::vector<ProductionBuilderElement> ProductionElement, std::size_t ProductionMask = 0)
-			: ProductionValue(ProductionValue), Element(std::move(ProductionElement)), ProductionMask(ProductionMask) {}
+		ProductionBuilder(Symbol ProductionValue, std::vector<ProductionBuilderElement> ProductionElement, std::size_t ProductionMask = 0, ReduceTypeE ReduceType = ReduceTypeE::Callback)
+			: ProductionValue(ProductionValue), Element(std::move(ProductionElement)), ProductionMask(ProductionMask), ReduceType(ReduceType) {}
 
 		ProductionBuilder(const ProductionBuilder&) = default;
 		ProductionBuilder(ProductionBuilder&&) = default;
@@ -107,6 +123,7 @@ export namespace Potato::SLRX
 		Symbol ProductionValue;
 		std::vector<ProductionBuilderElement> Element;
 		std::size_t ProductionMask = 0;
+		ReduceTypeE ReduceType = ReduceTypeE::Callback;
 	};
 
 	struct ProductionInfo
@@ -125,6 +142,7 @@ export namespace Potato::SLRX
 			Symbol Symbol;
 			std::size_t ProductionMask;
 			std::vector<Element> Elements;
+			ReduceTypeE ReduceType = ReduceTypeE::Callback;
 		};
 
 		struct SearchElement
@@ -190,10 +208,12 @@ export namespace Potato::SLRX
 		bool IsAvailable() const { return !Nodes.empty(); }
 		operator bool() const { return IsAvailable(); }
 
-		static LR0 Create(Symbol StartSymbol, std::vector<ProductionBuilder> Production, std::vector<OpePriority> Priority) {
-			return Create(ProductionInfo{ StartSymbol, std::move(Production), std::move(Priority) });
+		// ThreadCount > 1 expands the states of the same frontier in parallel, ThreadCount 0 means std::thread::hardware_concurrency.
+		// The result does not depend on ThreadCount.
+		static LR0 Create(Symbol StartSymbol, std::vector<ProductionBuilder> Production, std::vector<OpePriority> Priority, std::size_t ThreadCount = 1) {
+			return Create(ProductionInfo{ StartSymbol, std::move(Production), std::move(Priority) }, ThreadCount);
 		}
-		static LR0 Create(ProductionInfo Info);
+		static LR0 Create(ProductionInfo Info, std::size_t ThreadCount = 1);
 
 		LR0(Symbol StartSymbol, std::vector<ProductionBuilder> Production, std::vector<OpePriority> Priority)
 			: LR0(Create(StartSymbol, std::move(Production), std::move(Priority))) {}
@@ -219,6 +239,7 @@ export namespace Potato::SLRX
 		std::size_t ProductionCount;
 		std::size_t ProductionIndex;
 		std::size_t UserMask;
+		ReduceTypeE ReduceType = ReduceTypeE::Callback;
 	};
 
 	struct ProcessElement
@@ -280,7 +301,7 @@ export namespace Potato::SLRX
 		std::size_t StartupTokenIndex;
 	};
 
-	struct LRXProcessor;
+	struct LRXStateContext;
 
 	struct LRX
 	{
@@ -326,10 +347,12 @@ export namespace Potato::SLRX
 
 		static constexpr std::size_t DefaultMaxForwardDetect = 3;
 
-		static LRX Create(LR0 const& Table, std::size_t MaxForwardDetect = DefaultMaxForwardDetect);
-		static LRX Create(Symbol StartSymbol, std::vector<ProductionBuilder> Production, std::vector<OpePriority> Priority, std::size_t MaxForwardDetect = DefaultMaxForwardDetect)
+		// ThreadCount > 1 expands the lookahead of the nodes in parallel, ThreadCount 0 means std::thread::hardware_concurrency.
+		// The result does not depend on ThreadCount.
+		static LRX Create(LR0 const& Table, std::size_t MaxForwardDetect = DefaultMaxForwardDetect, std::size_t ThreadCount = 1);
+		static LRX Create(Symbol StartSymbol, std::vector<ProductionBuilder> Production, std::vector<OpePriority> Priority, std::size_t MaxForwardDetect = DefaultMaxForwardDetect, std::size_t ThreadCount = 1)
 		{
-			return Create(LR0{ StartSymbol, std::move(Production), std::move(Priority) }, MaxForwardDetect);
+			return Create(LR0::Create(StartSymbol, std::move(Production), std::move(Priority), ThreadCount), MaxForwardDetect, ThreadCount);
 		}
 		bool IsAvailable() const { return !Nodes.empty(); }
 		operator bool() const { return IsAvailable(); }
@@ -346,12 +369,12 @@ export namespace Potato::SLRX
 
 	private:
 
-		std::optional<TableConsumeResult> TableConsume(Symbol Value, LRXProcessor const& Info, SuggestSymbolFunctionT suggest_symbol) const;
-		std::optional<TableReduceResult> TableReduce(LRXProcessor const& Info) const;
+		std::optional<TableConsumeResult> TableConsume(Symbol Value, LRXStateContext const& Info, SuggestSymbolFunctionT suggest_symbol) const;
+		std::optional<TableReduceResult> TableReduce(LRXStateContext const& Info) const;
 
 		LRX(std::vector<Node> Nodes) : Nodes(std::move(Nodes)) {}
 
-		friend struct LRXProcessor;
+		friend struct LRXStateContext;
 	};
 
 	struct LRXBinaryTableWrapper
@@ -364,6 +387,9 @@ export namespace Potato::SLRX
 		static_assert(sizeof(HalfStandardT) * 2 == sizeof(StandardT));
 		static_assert(sizeof(HalfHalfStandardT) * 2 == sizeof(HalfStandardT));
 
+		static constexpr StandardT ContainerTag = 0x4158524C;
+		static constexpr StandardT ContainerVersion = 2;
+
 		struct alignas(alignof(StandardT)) ZipHeadT
 		{
 			StandardT NodeCount = 0;
@@ -394,6 +420,7 @@ export namespace Potato::SLRX
 			HalfStandardT ProductionIndex;
 			HalfStandardT ProductionCount;
 			HalfStandardT ReduceTupleCount;
+			HalfStandardT ReduceType;
 			StandardT Mask;
 			StandardT NoTerminalValue;
 		};
@@ -412,13 +439,18 @@ export namespace Potato::SLRX
 			return Create(LRX{ StartSymbol, std::move(Production), std::move(Priority), MaxForwardDetect });
 		}
 
+		static std::vector<StandardT> CreateContainer(LRX const& Le);
+
+		// Buffer is created by CreateContainer, return nullopt if it fails the BinaryTableContainer::Check.
+		static std::optional<LRXBinaryTableWrapper> FromContainer(std::span<StandardT const> Buffer, bool VerifyChecksum = false);
+
 		LRXBinaryTableWrapper(std::span<StandardT const> InputBuffer) : Buffer(InputBuffer) {}
 		LRXBinaryTableWrapper(LRXBinaryTableWrapper const&) = default;
 		LRXBinaryTableWrapper() = default;
 		LRXBinaryTableWrapper& operator=(LRXBinaryTableWrapper const&) = default;
 
-		std::optional<TableConsumeResult> TableConsume(Symbol Value, LRXProcessor const& Info, LRX::SuggestSymbolFunctionT suggest_symbol) const;
-		std::optional<TableReduceResult> TableReduce(LRXProcessor const& Info) const;
+		std::optional<TableConsumeResult> TableConsume(Symbol Value, LRXStateContext const& Info, LRX::SuggestSymbolFunctionT suggest_symbol) const;
+		std::optional<TableReduceResult> TableReduce(LRXStateContext const& Info) const;
 
 		Misc::StructedSerilizerReader<StandardT const> GetReader() const { return Misc::StructedSerilizerReader<StandardT const>(Buffer); }
 
@@ -468,7 +500,494 @@ export namespace Potato::SLRX
 	};
 
 
-	struct LRXProcessor
+	// Row displacement encoding of the LRX table. Every (Node, RequireNode) pair is an action row indexed by the terminal symbol,
+	// and every reduce property is a goto row indexed by the last state, so TableConsume is a constant time lookup.
+	// The node which reduces without any lookahead keeps the reduce as its default reduce.
+	struct LRXCompressedTableWrapper
+	{
+		using StandardT = std::uint32_t;
+
+		static constexpr StandardT ContainerTag = 0x4352584C;
+		static constexpr StandardT ContainerVersion = 2;
+		static constexpr StandardT NoReduce = std::numeric_limits<StandardT>::max();
+		static constexpr StandardT NoRow = std::numeric_limits<StandardT>::max();
+
+		// the low ActionBits of an action is ActionE, the rest is the RequireNode, the node or the reduce index.
+		enum class ActionE : StandardT
+		{
+			Error = 0,
+			RequireNode,
+			Shift,
+			Reduce,
+		};
+
+		static constexpr StandardT ActionBits = 2;
+
+		struct alignas(alignof(StandardT)) ZipHeadT
+		{
+			StandardT NodeCount = 0;
+			StandardT StartupNode = 0;
+			StandardT ColumnCount = 0;
+			StandardT RowCount = 0;
+			StandardT ActionSize = 0;
+			StandardT ReduceCount = 0;
+			StandardT GotoRowCount = 0;
+			StandardT GotoSize = 0;
+		};
+
+		struct alignas(alignof(StandardT)) ZipNodeT
+		{
+			StandardT FirstRow = 0;
+			StandardT DefaultReduce = NoReduce;
+		};
+
+		struct alignas(alignof(StandardT)) ZipReduceT
+		{
+			StandardT NoTerminalValue = 0;
+			StandardT ProductionIndex = 0;
+			StandardT ProductionCount = 0;
+			StandardT Mask = 0;
+			StandardT ReduceType = 0;
+			// the reduces with the same (LastState -> TargetState) tuples share the goto row.
+			StandardT GotoRow = 0;
+		};
+
+		static void Serilize(Misc::StructedSerilizerWritter<StandardT>& Writer, LRX const& Ref);
+
+		static std::vector<StandardT> Create(LRX const& Le);
+		static std::vector<StandardT> Create(Symbol StartSymbol, std::vector<ProductionBuilder> Production, std::vector<OpePriority> Priority, std::size_t MaxForwardDetect = 3) {
+			return Create(LRX{ StartSymbol, std::move(Production), std::move(Priority), MaxForwardDetect });
+		}
+
+		static std::vector<StandardT> CreateContainer(LRX const& Le);
+
+		// Buffer is created by CreateContainer, return nullopt if it fails the BinaryTableContainer::Check.
+		static std::optional<LRXCompressedTableWrapper> FromContainer(std::span<StandardT const> Buffer, bool VerifyChecksum = false);
+
+		LRXCompressedTableWrapper(std::span<StandardT const> InputBuffer);
+		LRXCompressedTableWrapper(LRXCompressedTableWrapper const&) = default;
+		LRXCompressedTableWrapper() = default;
+		LRXCompressedTableWrapper& operator=(LRXCompressedTableWrapper const&) = default;
+
+		std::optional<TableConsumeResult> TableConsume(Symbol Value, LRXStateContext const& Info, LRX::SuggestSymbolFunctionT suggest_symbol) const;
+		std::optional<TableReduceResult> TableReduce(LRXStateContext const& Info) const;
+
+		operator bool() const { return !Buffer.empty(); }
+		std::size_t NodeCount() const { return Nodes.size(); }
+		std::size_t StartupNodeIndex() const { return StartupNode; }
+		std::size_t TotalBufferSize() const { return Buffer.size(); }
+
+	protected:
+
+		LR0::Reduce GetReduce(std::size_t ReduceIndex) const;
+		std::size_t Goto(std::size_t ReduceIndex, std::size_t LastState) const;
+
+		std::span<StandardT const> Buffer;
+		std::size_t StartupNode = 0;
+		std::size_t ColumnCount = 0;
+		std::span<ZipNodeT const> Nodes;
+		std::span<StandardT const> ActionBase;
+		std::span<StandardT const> ActionCheck;
+		std::span<StandardT const> ActionValue;
+		std::span<ZipReduceT const> Reduces;
+		std::span<StandardT const> GotoBase;
+		std::span<StandardT const> GotoCheck;
+		std::span<StandardT const> GotoValue;
+	};
+
+	struct LRXStateElement
+	{
+		std::size_t TableState = 0;
+		SymbolInfo Value;
+	};
+
+	struct LRXStateSnapshot
+	{
+		std::size_t ConsumedCount = 0;
+		std::size_t TokenEnd = 0;
+		std::size_t CurrentTopState = 0;
+		std::size_t RequireNode = 0;
+		std::size_t ErrorCount = 0;
+		bool Recovering = false;
+		// the state stack is not kept, it is rebuilt from the value stack of the derived processor
+		std::vector<SymbolInfo> CacheSymbols;
+	};
+
+	// Pending lookahead of the processor. The capacity is a power of two and only grows, 
+	// so once it reaches the deepest forward detect of the table no more allocation happens.
+	template<typename Type>
+	struct LRXRingBuffer
+	{
+		LRXRingBuffer(std::size_t Capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Buffer(resource) { Reserve(Capacity); }
+
+		std::size_t Size() const { return Count; }
+		bool Empty() const { return Count == 0; }
+
+		Type& operator[](std::size_t Index) { assert(Index < Count); return Buffer[(Begin + Index) & (Buffer.size() - 1)]; }
+		Type const& operator[](std::size_t Index) const { assert(Index < Count); return Buffer[(Begin + Index) & (Buffer.size() - 1)]; }
+		Type& Front() { return (*this)[0]; }
+
+		void PushFront(Type Value)
+		{
+			if (Count == Buffer.size())
+				Reserve(Count + 1);
+			Begin = (Begin + Buffer.size() - 1) & (Buffer.size() - 1);
+			Buffer[Begin] = std::move(Value);
+			++Count;
+		}
+
+		void PushBack(Type Value)
+		{
+			if (Count == Buffer.size())
+				Reserve(Count + 1);
+			Buffer[(Begin + Count) & (Buffer.size() - 1)] = std::move(Value);
+			++Count;
+		}
+
+		Type PopFront()
+		{
+			assert(Count > 0);
+			Type Result = std::move(Buffer[Begin]);
+			Buffer[Begin] = Type{};
+			Begin = (Begin + 1) & (Buffer.size() - 1);
+			--Count;
+			return Result;
+		}
+
+		void PopBack()
+		{
+			assert(Count > 0);
+			--Count;
+			Buffer[(Begin + Count) & (Buffer.size() - 1)] = Type{};
+		}
+
+		void Clear()
+		{
+			while (Count > 0)
+				PopBack();
+			Begin = 0;
+		}
+
+		void Reserve(std::size_t Capacity)
+		{
+			if (Capacity <= Buffer.size())
+				return;
+			std::size_t NewCapacity = std::max(Buffer.size(), std::size_t(4));
+			while (NewCapacity < Capacity)
+				NewCapacity *= 2;
+			decltype(Buffer) NewBuffer(NewCapacity, Buffer.get_allocator());
+			for (std::size_t Index = 0; Index < Count; ++Index)
+				NewBuffer[Index] = std::move((*this)[Index]);
+			Buffer = std::move(NewBuffer);
+			Begin = 0;
+		}
+
+	protected:
+
+		std::pmr::vector<Type> Buffer;
+		std::size_t Begin = 0;
+		std::size_t Count = 0;
+	};
+
+	// State of the table walk, a stack of LRXStateElement and the pending lookahead only.
+	struct LRXStateContext
+	{
+		LRXStateContext(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: SyncSymbols(resource), CacheSymbols(LRX::DefaultMaxForwardDetect + 1, resource), States(resource) {}
+
+		std::size_t GetConsumedCount() const { return ConsumedCount; }
+
+		using ErrorFunctionT = TMP::FunctionRef<void(SymbolInfo Value)>;
+
+		// Keep parsing after an unexpected symbol, the symbol is reported to error_function and Consume still returns true.
+		// ErrorSymbol is a terminal which the lexer never produces, used by the error productions (such as Statement := ErrorSymbol ';').
+		// On error the states are popped until ErrorSymbol can be shifted, then the symbols are discarded until one can be consumed.
+		// A symbol in SyncSymbols (and EndOfFile) also pops the states until it can be consumed.
+		// No more error is reported until a symbol is consumed, only an EndOfFile which can't be consumed fails.
+		void SetRecovery(ErrorFunctionT error_function, std::optional<Symbol> ErrorSymbol = {}, std::span<Symbol const> SyncSymbols = {});
+		std::size_t GetErrorCount() const { return ErrorCount; }
+
+	protected:
+
+		using TableWrapperT = std::variant<
+			std::monostate,
+			std::reference_wrapper<LRX const>,
+			LRXBinaryTableWrapper,
+			LRXCompressedTableWrapper
+		>;
+
+		void SetTable(TableWrapperT Table, LRX::SuggestSymbolFunctionT suggest_function);
+		void ResetState();
+
+		std::optional<TableConsumeResult> TableConsume(Symbol Value) const;
+		std::optional<TableReduceResult> TableReduce() const;
+		void SaveState(LRXStateSnapshot& Output) const;
+		// States is left empty, the caller pushes the restored state stack
+		void LoadState(LRXStateSnapshot const& Input);
+
+		TableWrapperT TableWrapper;
+		LRX::SuggestSymbolFunctionT suggest_function;
+		ErrorFunctionT error_function;
+		std::optional<Symbol> ErrorSymbol;
+		std::pmr::vector<Symbol> SyncSymbols;
+
+		LRXRingBuffer<SymbolInfo> CacheSymbols;
+		std::pmr::vector<LRXStateElement> States;
+		std::size_t CurrentTopState = 0;
+		std::size_t RequireNode = 0;
+		std::size_t ConsumedCount = 0;
+		std::size_t TokenEnd = 0;
+		std::size_t ErrorCount = 0;
+		bool Recovering = false;
+		friend struct LRX;
+		friend struct LRXBinaryTableWrapper;
+		friend struct LRXCompressedTableWrapper;
+	};
+
+	// Drive the table with LRXStateContext, the semantic value is shifted and reduced by DerivedT.
+	// DerivedT provides the following, resolved statically :
+	// ShiftValue(LRXStateElement const&) : move the oldest cached value to the top of the value stack
+	// ReduceValue(LRXStateElement const&, ReduceInfo) : replace the last Desc.ProductionCount values by one, States still hold the elements of the production
+	// the following are only used by the error recovery
+	// PopFrontCacheValue() : drop the oldest cached value
+	// PopBackCacheValue() : drop the newest cached value
+	// PushErrorCacheValue() : cache an empty value for ErrorSymbol before the other cached values
+	// PopValue() : drop the top of the value stack
+	template<typename DerivedT>
+	struct LRXStateProcessor : public LRXStateContext
+	{
+		using LRXStateContext::LRXStateContext;
+
+	protected:
+
+		bool ConsumeSymbol(Symbol Value, Misc::IndexSpan<> TokenIndex);
+		bool ConsumeSymbolImp(Symbol Value, Misc::IndexSpan<> TokenIndex);
+		bool Recover(Symbol Value, Misc::IndexSpan<> TokenIndex);
+		bool PopUntilConsumable(Symbol Value);
+		void DropCacheSymbols();
+		void TryReduce();
+		void ApplyReduce(LR0::Reduce const& Reduce, std::size_t TargetState);
+
+		DerivedT& GetDerived() { return static_cast<DerivedT&>(*this); }
+	};
+
+	template<typename DerivedT>
+	void LRXStateProcessor<DerivedT>::ApplyReduce(LR0::Reduce const& Reduce, std::size_t TargetState)
+	{
+		Misc::IndexSpan<> Cur;
+		auto Productions = std::span(States.data(), States.size()).subspan(States.size() - Reduce.Reduce.element_count);
+		for (auto& Ite : Productions)
+		{
+			if (Ite.Value.TokenIndex.Size() != 0)
+			{
+				if (Cur.Size() == 0)
+				{
+					Cur = Ite.Value.TokenIndex;
+				}
+				else {
+					Cur = Cur.Expand(Ite.Value.TokenIndex);
+				}
+			}
+		}
+
+		LRXStateElement Element{
+			TargetState,
+			SymbolInfo{ Reduce.ReduceSymbol, Cur }
+		};
+
+		ReduceInfo Desc{
+			Reduce.Reduce.element_count,
+			Reduce.Reduce.production_index,
+			Reduce.Reduce.mask,
+			Reduce.Reduce.reduce_type
+		};
+
+		GetDerived().ReduceValue(Element, Desc);
+
+		States.resize(States.size() - Reduce.Reduce.element_count);
+		States.push_back(Element);
+		CurrentTopState = TargetState;
+	}
+
+	template<typename DerivedT>
+	bool LRXStateProcessor<DerivedT>::ConsumeSymbol(Symbol Value, Misc::IndexSpan<> TokenIndex)
+	{
+		if (ConsumeSymbolImp(Value, TokenIndex))
+		{
+			Recovering = false;
+			return true;
+		}
+		if (!error_function)
+			return false;
+		return Recover(Value, TokenIndex);
+	}
+
+	template<typename DerivedT>
+	bool LRXStateProcessor<DerivedT>::Recover(Symbol Value, Misc::IndexSpan<> TokenIndex)
+	{
+		if (!Recovering)
+		{
+			error_function(SymbolInfo{ Value, TokenIndex });
+			++ErrorCount;
+			Recovering = true;
+			DropCacheSymbols();
+			if (ErrorSymbol.has_value() && PopUntilConsumable(*ErrorSymbol))
+			{
+				GetDerived().PushErrorCacheValue();
+				[[maybe_unused]] auto Re = ConsumeSymbolImp(*ErrorSymbol, { TokenIndex.Begin(), TokenIndex.Begin() });
+				assert(Re);
+				--ConsumedCount;
+			}
+			if (ConsumeSymbolImp(Value, TokenIndex))
+			{
+				Recovering = false;
+				return true;
+			}
+		}
+
+		if (Value == Symbol::EndOfFile() || std::find(SyncSymbols.begin(), SyncSymbols.end(), Value) != SyncSymbols.end())
+		{
+			DropCacheSymbols();
+			if (PopUntilConsumable(Value))
+			{
+				[[maybe_unused]] auto Re = ConsumeSymbolImp(Value, TokenIndex);
+				assert(Re);
+				Recovering = false;
+				return true;
+			}
+		}
+
+		if (Value == Symbol::EndOfFile())
+			return false;
+
+		// ConsumedCount still counts the discarded symbol
+		++ConsumedCount;
+		TokenEnd = std::max(TokenEnd, TokenIndex.End());
+		GetDerived().PopBackCacheValue();
+		return true;
+	}
+
+	template<typename DerivedT>
+	void LRXStateProcessor<DerivedT>::DropCacheSymbols()
+	{
+		while (!CacheSymbols.Empty())
+		{
+			CacheSymbols.PopFront();
+			GetDerived().PopFrontCacheValue();
+		}
+		RequireNode = 0;
+	}
+
+	template<typename DerivedT>
+	bool LRXStateProcessor<DerivedT>::PopUntilConsumable(Symbol Value)
+	{
+		assert(CacheSymbols.Empty() && RequireNode == 0);
+		std::pmr::vector<LRXStateElement> Popped(States.get_allocator());
+		while (true)
+		{
+			CurrentTopState = States.rbegin()->TableState;
+			if (TableConsume(Value).has_value())
+			{
+				for (std::size_t Index = 0; Index < Popped.size(); ++Index)
+					GetDerived().PopValue();
+				return true;
+			}
+			if (States.size() == 1)
+				break;
+			Popped.push_back(*States.rbegin());
+			States.pop_back();
+		}
+		States.insert(States.end(), Popped.rbegin(), Popped.rend());
+		CurrentTopState = States.rbegin()->TableState;
+		return false;
+	}
+
+	template<typename DerivedT>
+	bool LRXStateProcessor<DerivedT>::ConsumeSymbolImp(Symbol Value, Misc::IndexSpan<> TokenIndex)
+	{
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		assert(Value.IsTerminal());
+		assert(States.rbegin()->TableState == CurrentTopState);
+
+		auto Result = TableConsume(Value);
+
+		if (Result.has_value())
+		{
+			++ConsumedCount;
+			TokenEnd = std::max(TokenEnd, TokenIndex.End());
+			CacheSymbols.PushBack(SymbolInfo{ Value, TokenIndex });
+			std::size_t SymbolsIndex = 0;
+			while (SymbolsIndex <= CacheSymbols.Size())
+			{
+				if (Result->Reduce.has_value())
+				{
+					ApplyReduce(*Result->Reduce, Result->State);
+					RequireNode = Result->RequireNode;
+					SymbolsIndex = 0;
+					TryReduce();
+				}
+				else {
+					if (Result->RequireNode == 0)
+					{
+						auto LastSymbol = CacheSymbols.PopFront();
+						States.push_back({ Result->State, LastSymbol });
+						GetDerived().ShiftValue(*States.rbegin());
+						RequireNode = Result->RequireNode;
+						CurrentTopState = Result->State;
+						SymbolsIndex = 0;
+						if (LastSymbol.Value != Symbol::EndOfFile())
+						{
+							TryReduce();
+						}
+						else {
+							assert(CacheSymbols.Empty());
+							assert(States.size() == 3);
+						}
+					}
+					else {
+						RequireNode = Result->RequireNode;
+						return true;
+					}
+				}
+				if (!CacheSymbols.Empty())
+				{
+					Result = TableConsume(CacheSymbols[SymbolsIndex].Value);
+					++SymbolsIndex;
+					assert(Result.has_value());
+				}
+				else {
+					return true;
+				}
+			}
+			return true;
+		}
+		else {
+			return false;
+		}
+	}
+
+	template<typename DerivedT>
+	void LRXStateProcessor<DerivedT>::TryReduce()
+	{
+		assert(!std::holds_alternative<std::monostate>(TableWrapper));
+		if (RequireNode == 0)
+		{
+			while (true)
+			{
+				auto Result = TableReduce();
+				if (Result.has_value())
+				{
+					ApplyReduce(Result->Reduce, Result->State);
+				}
+				else {
+					break;
+				}
+			}
+		}
+	}
+
+	struct LRXProcessor : public LRXStateProcessor<LRXProcessor>
 	{
 		struct AppendedSymbolInfo
 		{
@@ -483,6 +1002,8 @@ export namespace Potato::SLRX
 
 		void SetObserverTable(LRXBinaryTableWrapper Table, LRX::ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function = {});
 
+		void SetObserverTable(LRXCompressedTableWrapper Table, LRX::ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function = {});
+
 		std::any& GetDataRaw();
 
 		template<typename RequrieT>
@@ -492,28 +1013,173 @@ export namespace Potato::SLRX
 
 		void Clear();
 
+		// node of a persistent stack, the snapshots share the elements which were not reduced between them.
+		struct SnapshotElement
+		{
+			ProcessElement Element;
+			std::shared_ptr<SnapshotElement> Prev;
+
+			~SnapshotElement() {
+				// release a long stack iteratively
+				while (Prev && Prev.use_count() == 1)
+					Prev = std::move(Prev->Prev);
+			}
+		};
+
+		struct Snapshot : public LRXStateSnapshot
+		{
+			std::shared_ptr<SnapshotElement> TopElement;
+			std::size_t ElementCount = 0;
+			std::vector<std::any> CacheDatas;
+		};
+
+		// take a snapshot every Interval consumed symbols, 0 to disable. Clear() drops the snapshots.
+		// A snapshot only copies the elements changed since the previous one, the state stack is rebuilt from the elements.
+		void SetSnapshotInterval(std::size_t Interval) { SnapshotInterval = Interval; }
+
+		// for incremental reparse, restore the latest snapshot which only consumed symbols ending not after EditBegin,
+		// return the count of kept symbols, the caller should consume again from this symbol.
+		// The symbols after the edit are always parsed again, the suffix of the old parse is not reused.
+		std::size_t RestoreBefore(std::size_t EditBegin);
+
+		// keep the first SnapshotCount snapshots and restore the last of them (Clear() if 0), return the count of kept symbols.
+		std::size_t RestoreSnapshot(std::size_t SnapshotCount);
+
+		std::span<Snapshot const> GetSnapshots() const { return std::span(Snapshots.data(), Snapshots.size()); }
+
 		LRXProcessor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
-			: CacheSymbols(resource), States(resource) {}
+			: LRXStateProcessor(resource), CacheDatas(LRX::DefaultMaxForwardDetect + 1, resource), Elements(resource), Snapshots(resource) {}
 
 	protected:
 
-		std::variant<
-			std::monostate,
-			std::reference_wrapper<LRX const>,
-			LRXBinaryTableWrapper
-		> TableWrapper;
+		void ShiftValue(LRXStateElement const& Element);
+		void ReduceValue(LRXStateElement const& Element, ReduceInfo Desc);
+		void PopFrontCacheValue() { CacheDatas.PopFront(); }
+		void PopBackCacheValue() { CacheDatas.PopBack(); }
+		void PushErrorCacheValue() { CacheDatas.PushFront({}); }
+		void PopValue() { Elements.pop_back(); UnchangedElementCount = std::min(UnchangedElementCount, Elements.size()); }
 
 		LRX::ReduceSymbolFunctionT reduce_function;
-		LRX::SuggestSymbolFunctionT suggest_function;
 
-		void TryReduce();
+		LRXRingBuffer<std::any> CacheDatas;
+		std::pmr::vector<ProcessElement> Elements;
+		std::size_t SnapshotInterval = 0;
+		std::pmr::vector<Snapshot> Snapshots;
+		// count of the bottom Elements which are not changed since the latest snapshot
+		std::size_t UnchangedElementCount = 0;
 
-		std::pmr::deque<ProcessElement> CacheSymbols;
-		std::pmr::vector<ProcessElement> States;
-		std::size_t CurrentTopState = 0;
-		std::size_t RequireNode = 0;
-		friend struct LRX;
-		friend struct LRXBinaryTableWrapper;
+		friend struct LRXStateProcessor<LRXProcessor>;
+	};
+
+	template<typename ValueT>
+	struct LRXValueReduceProduction : public ReduceInfo
+	{
+		std::span<LRXStateElement const> Symbols;
+		std::span<ValueT> Elements;
+		ValueT& operator[](std::size_t Index) { return Elements[Index]; }
+		std::size_t Size() const { return Elements.size(); }
+	};
+
+	// LRXProcessor with the semantic value declared as ValueT (usually a std::variant), 
+	// the values live in contiguous pmr stacks, so shift and reduce never type erase or allocate per value.
+	template<typename ValueT>
+	struct LRXValueProcessor : public LRXStateProcessor<LRXValueProcessor<ValueT>>
+	{
+		static_assert(std::is_default_constructible_v<ValueT> && std::is_move_constructible_v<ValueT>);
+
+		using ReduceSymbolFunctionT = TMP::FunctionRef<ValueT(SymbolInfo Value, LRXValueReduceProduction<ValueT> Desc)>;
+
+		bool Consume(Symbol Value, Misc::IndexSpan<> TokenIndex, ValueT AppendValue)
+		{
+			CacheValues.PushBack(std::move(AppendValue));
+			if (this->ConsumeSymbol(Value, TokenIndex))
+				return true;
+			CacheValues.PopBack();
+			return false;
+		}
+
+		bool EndOfFile() { return Consume(Symbol::EndOfFile(), {}, ValueT{}); }
+
+		void SetObserverTable(LRX const& Table, ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function = {})
+		{
+			SetObserverTableImp(std::reference_wrapper<LRX const>{Table}, reduce_function, suggest_function);
+		}
+
+		void SetObserverTable(LRXBinaryTableWrapper Table, ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function = {})
+		{
+			SetObserverTableImp(Table, reduce_function, suggest_function);
+		}
+
+		void SetObserverTable(LRXCompressedTableWrapper Table, ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function = {})
+		{
+			SetObserverTableImp(Table, reduce_function, suggest_function);
+		}
+
+		ValueT& GetData()
+		{
+			assert(Values.size() == 3);
+			return Values[1];
+		}
+
+		void Clear()
+		{
+			assert(reduce_function);
+			this->ResetState();
+			CacheValues.Clear();
+			Values.clear();
+			Values.emplace_back();
+			this->TryReduce();
+		}
+
+		LRXValueProcessor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: LRXStateProcessor<LRXValueProcessor<ValueT>>(resource), CacheValues(LRX::DefaultMaxForwardDetect + 1, resource), Values(resource) {}
+
+	protected:
+
+		void SetObserverTableImp(LRXStateContext::TableWrapperT Table, ReduceSymbolFunctionT reduce_function, LRX::SuggestSymbolFunctionT suggest_function)
+		{
+			assert(reduce_function);
+			this->reduce_function = reduce_function;
+			this->SetTable(std::move(Table), suggest_function);
+			Clear();
+		}
+
+		void ShiftValue(LRXStateElement const&)
+		{
+			Values.push_back(CacheValues.PopFront());
+		}
+
+		void ReduceValue(LRXStateElement const& Element, ReduceInfo Desc)
+		{
+			assert(Values.size() >= Desc.ProductionCount && this->States.size() == Values.size());
+			auto Offset = Values.size() - Desc.ProductionCount;
+			if (Desc.ReduceType == ReduceTypeE::PassThrough)
+			{
+				assert(Desc.ProductionCount > 0);
+				Values.erase(Values.begin() + Offset + 1, Values.end());
+				return;
+			}
+			LRXValueReduceProduction<ValueT> Pro{
+				Desc,
+				std::span(this->States).subspan(Offset),
+				std::span(Values).subspan(Offset)
+			};
+			auto Result = reduce_function(Element.Value, Pro);
+			Values.erase(Values.begin() + Offset, Values.end());
+			Values.push_back(std::move(Result));
+		}
+
+		void PopFrontCacheValue() { CacheValues.PopFront(); }
+		void PopBackCacheValue() { CacheValues.PopBack(); }
+		void PushErrorCacheValue() { CacheValues.PushFront(ValueT{}); }
+		void PopValue() { Values.pop_back(); }
+
+		ReduceSymbolFunctionT reduce_function;
+
+		LRXRingBuffer<ValueT> CacheValues;
+		std::pmr::vector<ValueT> Values;
+
+		friend struct LRXStateProcessor<LRXValueProcessor<ValueT>>;
 	};
 
 	namespace Exception
@@ -529,7 +1195,8 @@ export namespace Potato::SLRX
 			enum class Category
 			{
 				TerminalSymbolAsProductionBegin,
-				MaskNotFolloedNoterminalSymbol
+				MaskNotFolloedNoterminalSymbol,
+				PassThroughWithoutElement,
 			};
 
 			Category Type;
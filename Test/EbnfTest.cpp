@@ -1,5 +1,7 @@
 import std;
-//import PotatoEBNF;
+import PotatoEBNF;
+
+using namespace Potato::EBNF;
 
 /*
 struct StringMaker : public EbnfOperator
@@ -149,8 +151,122 @@ $ := <Exp> ;
 }
 */
 
+std::u8string_view RestoreEbnfCode = u8R"(
+Num := '[0-9]+' : [1];
+$ := '\s+';
+
+%%%%
+
+$ := <Exp> ;
+
+<Exp> := Num : [1];
+	:= <Exp> '+' <Exp> : [2];
+	:= <Exp> '*' <Exp> : [3];
+	:= <Exp> '/' <Exp> : [4];
+	:= <Exp> '-' <Exp> : [5];
+	:= '<' <Exp> '>' : [6];
+
+%%%%
+
++('*' '/');
++('+' '-');
+)";
+
+void TestRestoreBefore(const char* Error)
+{
+	try {
+		Ebnf Tab{ RestoreEbnfCode };
+		auto Buffer = CreateEbnfBinaryTable(Tab);
+
+		std::u8string_view Source = u8"1 * < 2 + 3 > * 4 + 5 * 6 + 7";
+		std::u8string_view EditedSource = u8"1 * < 2 + 3 > * 40 + 51 * 2 * 6 + 7";
+		std::size_t EditBegin = static_cast<std::size_t>(std::mismatch(Source.begin(), Source.end(), EditedSource.begin()).first - Source.begin());
+
+		std::u8string_view Current;
+
+		auto HandleSymbol = [&](SymbolInfo Symbol, std::size_t UserMask) -> std::any {
+			if (UserMask != 1)
+				return {};
+			std::size_t Value = 0;
+			for (auto Ite : Symbol.TokenIndex.Slice(Current))
+				Value = Value * 10 + static_cast<std::size_t>(Ite - u8'0');
+			return Value;
+		};
+
+		auto HandleReduce = [](SymbolInfo, ReduceProduction Production) -> std::any {
+			switch (Production.UserMask)
+			{
+			case 1:
+				return Production[0].Consume<std::size_t>();
+			case 2:
+				return Production[0].Consume<std::size_t>() + Production[2].Consume<std::size_t>();
+			case 3:
+				return Production[0].Consume<std::size_t>() * Production[2].Consume<std::size_t>();
+			case 4:
+				return Production[0].Consume<std::size_t>() / Production[2].Consume<std::size_t>();
+			case 5:
+				return Production[0].Consume<std::size_t>() - Production[2].Consume<std::size_t>();
+			case 6:
+				return Production[1].Consume<std::size_t>();
+			default:
+				return {};
+			}
+		};
+
+		auto Check = [&](EbnfProcessor& Pro, std::size_t StartupTokenIndex) {
+
+			Current = Source;
+			if (!Process(Pro, Source) || Pro.GetData<std::size_t>() != 57)
+				throw Error;
+
+			// edit the middle of the input, only the part from the returned token index is lexed and parsed again
+			Current = EditedSource;
+			auto Restart = Pro.RestoreBefore(EditBegin);
+			if (Restart <= StartupTokenIndex || Restart > EditBegin)
+				throw Error;
+			if (!Process(Pro, EditedSource))
+				throw Error;
+
+			EbnfProcessor Fresh;
+			Fresh.SetObserverTable(Tab, HandleSymbol, HandleReduce);
+			if (!Process(Fresh, EditedSource))
+				throw Error;
+
+			auto Result = Pro.GetData<std::size_t>();
+			if (Result != Fresh.GetData<std::size_t>() || Result != 819)
+				throw Error;
+
+			// restore to the startup, the whole input is parsed again
+			Current = Source;
+			if (Pro.RestoreBefore(0) != StartupTokenIndex || !Process(Pro, Source) || Pro.GetData<std::size_t>() != 57)
+				throw Error;
+		};
+
+		EbnfProcessor Pro;
+		Pro.SetObserverTable(Tab, HandleSymbol, HandleReduce);
+		Pro.SetSnapshotInterval(1);
+		Check(Pro, 0);
+
+		Pro.SetObserverTable(EbnfBinaryTableWrapper{ std::span(Buffer) }, HandleSymbol, HandleReduce);
+		Check(Pro, 0);
+	}
+	catch (std::exception const&)
+	{
+		throw Error;
+	}
+}
+
 int main()
 {
+	try
+	{
+		TestRestoreBefore("TestingEbnf : RestoreBefore");
+	}
+	catch (char const* Error)
+	{
+		std::cout << Error << std::endl;
+		return -1;
+	}
 	/*
 	try
 	{
@@ -162,5 +278,6 @@ int main()
 		return -1;
 	}
 	*/
+	std::cout << "TestingEbnf Pass !" << std::endl;
 	return 0;
-}
\ No newline at end of file
+}
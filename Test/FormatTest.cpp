@@ -15,7 +15,11 @@ struct K
 
 namespace Potato::Format
 {
-	
+	template<>
+	struct StaticPatternTable<u8"id:">
+	{
+		static constexpr bool Value = true;
+	};
 }
 
 struct Ref
@@ -124,6 +128,13 @@ int main()
 
 			volatile int i = 0;
 		}
+
+		{
+			std::int32_t id = 0;
+			auto info = Deformat<u8"id:{}">(std::u8string_view{ u8"id:42" }, id);
+			if (!info || id != 42)
+				throw "case 7";
+		}
 		
 	}
 	catch (const char* Error)
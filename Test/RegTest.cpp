@@ -1,9 +1,11 @@
 ﻿#include <ctre-unicode.hpp>
 
 import std;
+import PotatoTMP;
 import PotatoReg;
 import PotatoLog;
 import PotatoEncode;
+import PotatoStreamer;
 using namespace Potato;
 using namespace Potato::Reg;
 
@@ -180,6 +182,133 @@ std::size_t FuncTell(std::u8string_view str)
 	return str.size();
 }
 
+struct StringStreamReader : public Potato::Streamer::StreamReader
+{
+	std::u8string_view str;
+	std::size_t offset = 0;
+	StringStreamReader(std::u8string_view str) : str(str) {}
+	std::size_t StreamRead(std::byte* out, std::size_t byte) override
+	{
+		auto count = std::min(byte, str.size() - offset);
+		std::memcpy(out, str.data() + offset, count);
+		offset += count;
+		return count;
+	}
+	Potato::Streamer::StreamState GetStreamState() const override { return offset == str.size() ? Potato::Streamer::StreamState::Depletion : Potato::Streamer::StreamState::OK; }
+};
+
+// shared by the differential tests : classes, alternation, counters, captures and non-ASCII input
+std::vector<std::u8string_view> DiffPatterns = {
+	u8"[0-9a-zA-Z][0-9a-zA-Z]*",
+	u8"if|else|while|[a-z_][a-z_0-9]*",
+	u8"([0-9]{2,4})x",
+	u8"[a-z]{1,3}[0-9]",
+	u8"x{2,5}y?",
+	u8"([a-z]+)@([a-z]+)\\.com",
+	u8"([0-9]+)\\.([0-9]+)",
+	u8"[^0-9 ]+",
+	u8"(ab|cd)*[à-ÿ]",
+	u8"[一-龥]+|été",
+};
+
+std::vector<std::u8string_view> DiffInputs = {
+	u8"", u8"abc123 x", u8"if(", u8"else1", u8"2024x", u8"abc1", u8"xxxxxxy", u8"xx", u8"foo@bar.com",
+	u8"12.5", u8"ababcdà", u8"été", u8"中文字符abc", u8"abc@def.co", u8"-x-", u8"\U0001F600ab"
+};
+
+bool IsSameAccept(ProcessorAcceptRef const& A, ProcessorAcceptRef const& B)
+{
+	if (static_cast<bool>(A) != static_cast<bool>(B))
+		return false;
+	if (!A)
+		return true;
+	if (A.GetMask() != B.GetMask() || A.GetMainCapture() != B.GetMainCapture() || A.GetCaptureSize() != B.GetCaptureSize())
+		return false;
+	for (std::size_t index = 0; index < A.GetCaptureSize(); ++index)
+	{
+		if (A.GetCapture(index) != B.GetCapture(index))
+			return false;
+	}
+	return true;
+}
+
+template<typename Table1T, typename Table2T, typename StrT>
+bool IsSameProcess(Table1T const& Table1, Table2T const& Table2, StrT Str)
+{
+	Potato::Reg::DfaProcessor processer1;
+	Potato::Reg::DfaProcessor processer2;
+	processer1.SetObserverTable(Table1);
+	processer2.SetObserverTable(Table2);
+	return IsSameAccept(processer1.Process(Str), processer2.Process(Str));
+}
+
+// for the tables which do not track the sub captures, only the mask and the main capture are compared
+template<typename Table1T, typename Table2T, typename StrT>
+bool IsSameMainProcess(Table1T& Table1, Table2T& Table2, StrT Str)
+{
+	Potato::Reg::DfaProcessor processer1;
+	Potato::Reg::DfaProcessor processer2;
+	processer1.SetObserverTable(Table1);
+	processer2.SetObserverTable(Table2);
+	auto match1 = processer1.Process(Str);
+	auto match2 = processer2.Process(Str);
+	if (bool(match1) != bool(match2))
+		return false;
+	return !match1 || (match1.GetMask() == match2.GetMask() && match1.GetMainCapture() == match2.GetMainCapture());
+}
+
+template<typename TableT, typename StrT>
+bool IsSameBatch(TableT const& Table, std::vector<StrT> const& Strs, std::size_t ThreadCount)
+{
+	Potato::Reg::DfaBatchProcessor batch_processer;
+	batch_processer.SetObserverTable(Table);
+	auto result = batch_processer.Process(std::span<StrT const>(Strs), ThreadCount);
+	if (result.size() != Strs.size())
+		return false;
+	Potato::Reg::DfaProcessor processer;
+	processer.SetObserverTable(Table);
+	for (std::size_t index = 0; index < Strs.size(); ++index)
+	{
+		processer.Clear();
+		if (!IsSameAccept(batch_processer[index], processer.Process(Strs[index])))
+			return false;
+	}
+	return true;
+}
+
+std::vector<std::u8string_view> StaticInputs = {
+	u8"", u8"abc123 x", u8"if", u8"else1", u8"while", u8"foo@bar.com", u8"foo@bar.co", u8"12.5", u8"12.", u8"ababcdà", u8"ab", u8"été", u8"中文字符abc",
+	u8"\U0001F600ab", u8"aaab", u8"abcd", u8"abcx", u8"abx", u8"ifels", u8"ifelse", u8"acd", u8"sdLoc:[ 12", u8"Loc:", u8"xLo", u8"-x-", u8" 9"
+};
+
+// The static subset has no capture, so the runtime table built from the same pattern must not report any capture either.
+template<Potato::TMP::TypeString Pattern, Dfa::FormatE Format>
+bool IsSameStaticFormat()
+{
+	using StaticTable = Potato::Reg::StaticDfaBinaryTable<Pattern, Format>;
+	static_assert(StaticTable::Available);
+	Potato::Reg::Dfa runtime_dfa(Format, Pattern.GetStringView());
+	Potato::Reg::DfaBinaryTableWrapper static_wrapper{ StaticTable::Buffer };
+	Potato::Reg::DfaProcessor runtime_processer;
+	Potato::Reg::DfaProcessor static_processer;
+	runtime_processer.SetObserverTable(runtime_dfa);
+	static_processer.SetObserverTable(static_wrapper);
+	for (auto input : StaticInputs)
+	{
+		runtime_processer.Clear();
+		static_processer.Clear();
+		if (!IsSameAccept(runtime_processer.Process(input), static_processer.Process(input)))
+			return false;
+	}
+	return true;
+}
+
+template<Potato::TMP::TypeString ...Patterns>
+bool IsSameStatic()
+{
+	return ((IsSameStaticFormat<Patterns, Dfa::FormatE::Match>() && IsSameStaticFormat<Patterns, Dfa::FormatE::HeadMatch>() && IsSameStaticFormat<Patterns, Dfa::FormatE::GreedyHeadMatch>()) && ...);
+}
+
 int main()
 {
 
@@ -217,6 +346,727 @@ int main()
 		Potato::Log::Log<u8"Test", Potato::Log::LogLevel::Log, L" Test: {} - {}">(total_index, cur8 - cur7);
 	}
 	
+	std::this_thread::sleep_for(std::chrono::seconds{1});
+
+	Potato::Reg::Dfa class_dfa(Dfa::FormatE::HeadMatch, u8"[0-9a-zA-Z][0-9a-zA-Z]*");
+	class_dfa.BuildClassTable();
+	auto class_k = Potato::Reg::CreateDfaBinaryTable(class_dfa);
+	Potato::Reg::DfaBinaryTableWrapper class_wrapper{ std::span(class_k) };
+
+	{
+		total_index = 0;
+		processer.SetObserverTable(class_dfa);
+		auto cur7 = std::chrono::system_clock::now();
+		for (std::size_t i = 0; i < 10000; ++i)
+		{
+			processer.Clear();
+			auto match = processer.Process(str);
+			total_index += match.GetMainCapture().End();
+		}
+		auto cur8 = std::chrono::system_clock::now();
+		Potato::Log::Log<u8"Test", Potato::Log::LogLevel::Log, L" Test Class: {} - {}">(total_index, cur8 - cur7);
+	}
+
+	{
+		for (auto pattern : DiffPatterns)
+		{
+			for (auto format : { Dfa::FormatE::Match, Dfa::FormatE::HeadMatch, Dfa::FormatE::GreedyHeadMatch })
+			{
+				Potato::Reg::Dfa edge_dfa(format, pattern);
+				Potato::Reg::Dfa class_table_dfa = edge_dfa;
+				class_table_dfa.BuildClassTable();
+				auto edge_k = Potato::Reg::CreateDfaBinaryTable(edge_dfa);
+				auto class_table_k = Potato::Reg::CreateDfaBinaryTable(class_table_dfa);
+				Potato::Reg::DfaBinaryTableWrapper edge_wrapper{ std::span(edge_k) };
+				Potato::Reg::DfaBinaryTableWrapper class_table_wrapper{ std::span(class_table_k) };
+				for (auto input : DiffInputs)
+				{
+					if (!IsSameProcess(edge_dfa, class_table_dfa, input) || !IsSameProcess(edge_wrapper, class_table_wrapper, input) || !IsSameProcess(edge_dfa, class_table_wrapper, input))
+						throw "ClassTable Error";
+				}
+			}
+		}
+	}
+
+	{
+		// after x and after y the nodes only differ by the nfa states, the minimal table merges them
+		for (auto format : { Dfa::FormatE::Match, Dfa::FormatE::HeadMatch, Dfa::FormatE::GreedyHeadMatch })
+		{
+			Potato::Reg::Nfa redundant_nfa(u8"xa*|ya*");
+			Potato::Reg::Dfa full_dfa(format, redundant_nfa, 1, std::numeric_limits<std::size_t>::max(), false);
+			Potato::Reg::Dfa minimal_dfa(format, redundant_nfa);
+			if (minimal_dfa.GetNodeCount() >= full_dfa.GetNodeCount())
+				throw "Minimize Error";
+			for (std::u8string_view input : { u8"xaaa", u8"yaa", u8"ya", u8"xb" })
+			{
+				if (!IsSameProcess(full_dfa, minimal_dfa, input))
+					throw "Minimize Error";
+			}
+		}
+
+		for (auto pattern : DiffPatterns)
+		{
+			Potato::Reg::Nfa anchored_nfa(pattern);
+			for (auto format : { Dfa::FormatE::Match, Dfa::FormatE::HeadMatch, Dfa::FormatE::GreedyHeadMatch })
+			{
+				Potato::Reg::Dfa full_dfa(format, anchored_nfa, 1, std::numeric_limits<std::size_t>::max(), false);
+				Potato::Reg::Dfa minimal_dfa(format, anchored_nfa);
+				for (auto input : DiffInputs)
+				{
+					if (!IsSameProcess(full_dfa, minimal_dfa, input))
+						throw "Minimize Error";
+				}
+
+				// the counters can not follow the implicit lazy prefix of an unanchored table
+				std::optional<Potato::Reg::Dfa> full_search_dfa;
+				std::optional<Potato::Reg::Dfa> minimal_search_dfa;
+				try {
+					Potato::Reg::Nfa unanchored_nfa(pattern);
+					unanchored_nfa.MakeUnanchored();
+					full_search_dfa.emplace(format, unanchored_nfa, 1, std::numeric_limits<std::size_t>::max(), false);
+					minimal_search_dfa.emplace(format, unanchored_nfa);
+				}
+				catch (Potato::Reg::Exception::Interface const&)
+				{
+					continue;
+				}
+				Potato::Reg::DfaProcessor full_processer;
+				Potato::Reg::DfaProcessor minimal_processer;
+				full_processer.SetObserverTable(*full_search_dfa);
+				minimal_processer.SetObserverTable(*minimal_search_dfa);
+				for (auto input : DiffInputs)
+				{
+					if (!IsSameAccept(full_processer.Search(input), minimal_processer.Search(input)))
+						throw "Minimize Error";
+				}
+			}
+		}
+	}
+
+	std::this_thread::sleep_for(std::chrono::seconds{1});
+
+	{
+		total_index = 0;
+		processer.SetObserverTable(class_wrapper);
+		auto cur1 = std::chrono::system_clock::now();
+		for (std::size_t i = 0; i < 10000; ++i)
+		{
+			processer.Clear();
+			auto match = processer.Process(str);
+			total_index += match.GetMainCapture().End();
+		}
+		auto cur2 = std::chrono::system_clock::now();
+		Potato::Log::Log<u8"Test", Potato::Log::LogLevel::Log, L" Test Class Binary: {} - {}">(total_index, cur2 - cur1);
+	}
+
+	std::this_thread::sleep_for(std::chrono::seconds{1});
+
+	class_dfa.BuildUtf8Table();
+	auto utf8_k = Potato::Reg::CreateDfaBinaryTable(class_dfa);
+	Potato::Reg::DfaBinaryTableWrapper utf8_wrapper{ std::span(utf8_k) };
+
+	{
+		total_index = 0;
+		processer.SetObserverTable(utf8_wrapper);
+		auto cur1 = std::chrono::system_clock::now();
+		for (std::size_t i = 0; i < 10000; ++i)
+		{
+			processer.Clear();
+			auto match = processer.Process(str);
+			total_index += match.GetMainCapture().End();
+		}
+		auto cur2 = std::chrono::system_clock::now();
+		Potato::Log::Log<u8"Test", Potato::Log::LogLevel::Log, L" Test Utf8 Binary: {} - {}">(total_index, cur2 - cur1);
+	}
+
+	{
+		std::vector<std::u8string> utf8_inputs(DiffInputs.begin(), DiffInputs.end());
+		// invalid lead byte, stray continuation byte and a code point truncated at the end
+		utf8_inputs.push_back(std::u8string{ u8"été" }.insert(2, 1, char8_t(0xFF)));
+		utf8_inputs.push_back(std::u8string{ u8"ab" }.insert(1, 1, char8_t(0x80)));
+		utf8_inputs.push_back(std::u8string{ u8"abc中" }.substr(0, 5));
+		utf8_inputs.push_back(std::u8string{ u8"中文" }.substr(0, 4));
+		for (auto pattern : DiffPatterns)
+		{
+			for (auto format : { Dfa::FormatE::Match, Dfa::FormatE::HeadMatch, Dfa::FormatE::GreedyHeadMatch })
+			{
+				Potato::Reg::Dfa code_point_dfa(format, pattern);
+				code_point_dfa.BuildClassTable();
+				Potato::Reg::Dfa byte_dfa = code_point_dfa;
+				byte_dfa.BuildUtf8Table();
+				auto byte_k = Potato::Reg::CreateDfaBinaryTable(byte_dfa);
+				Potato::Reg::DfaBinaryTableWrapper byte_wrapper{ std::span(byte_k) };
+				for (auto& input : utf8_inputs)
+				{
+					std::u8string_view input_view = input;
+					if (!IsSameProcess(code_point_dfa, byte_dfa, input_view) || !IsSameProcess(code_point_dfa, byte_wrapper, input_view))
+						throw "Utf8Table Error";
+				}
+			}
+		}
+	}
+
+	std::this_thread::sleep_for(std::chrono::seconds{1});
+
+	{
+		std::u8string scan_str(1024 * 1024, u8'x');
+		scan_str += u8"hello world";
+		Potato::Reg::Dfa scan_dfa(Dfa::FormatE::HeadMatch, u8"hello ([a-z]+)");
+		Potato::Reg::DfaProcessor scan_processer;
+		scan_processer.SetObserverTable(scan_dfa);
+		total_index = 0;
+		auto cur1 = std::chrono::system_clock::now();
+		for (std::size_t i = 0; i < 100; ++i)
+		{
+			auto match = scan_processer.ScanProcess(std::u8string_view{ scan_str });
+			total_index += match.GetCapture(0).Begin();
+		}
+		auto cur2 = std::chrono::system_clock::now();
+		Potato::Log::Log<u8"Test", Potato::Log::LogLevel::Log, L" Test Scan: {} - {}">(total_index, cur2 - cur1);
+	}
+
+	{
+		// the match is placed at every position around the 16/32 byte blocks, the filler is full of false positive lead bytes
+		for (std::u8string_view pattern : { u8"hello ([a-z]+)", u8"ab[0-9]+", u8"[qz]([0-9])", u8"中文" })
+		{
+			std::u8string_view target = (pattern == u8"hello ([a-z]+)") ? u8"hello ab" : ((pattern == u8"ab[0-9]+") ? u8"ab12" : ((pattern == u8"中文") ? u8"中文" : u8"z5"));
+			Potato::Reg::Dfa scan_dfa(Dfa::FormatE::HeadMatch, pattern);
+			Potato::Reg::Nfa search_nfa(pattern);
+			search_nfa.MakeUnanchored();
+			Potato::Reg::Dfa search_dfa(Dfa::FormatE::HeadMatch, search_nfa);
+			Potato::Reg::DfaProcessor filter_processer;
+			Potato::Reg::DfaProcessor unfiltered_processer;
+			Potato::Reg::DfaProcessor search_processer;
+			filter_processer.SetObserverTable(scan_dfa);
+			unfiltered_processer.SetObserverTable(scan_dfa);
+			search_processer.SetObserverTable(search_dfa);
+			if (!filter_processer.GetPrefilter().IsAvailable())
+				throw "Prefilter Error";
+			for (std::size_t length : { 15, 16, 17, 31, 32, 33 })
+			{
+				for (std::size_t position = 0; position + target.size() <= length; ++position)
+				{
+					auto filler = [](std::size_t size) {
+						std::u8string result;
+						for (std::size_t index = 0; result.size() < size; ++index)
+						{
+							std::u8string_view ite = std::array<std::u8string_view, 7>{ u8"h", u8"e", u8"a", u8"q", u8"丁", u8"z", u8" " }[index % 7];
+							result += (result.size() + ite.size() <= size) ? ite : u8" ";
+						}
+						return result;
+					};
+					std::u8string scan_str = filler(position) + std::u8string{ target } + filler(length - position - target.size());
+					std::u8string_view scan_view = scan_str;
+
+					ProcessorAcceptRef unfiltered;
+					for (std::size_t offset = 0; offset <= scan_view.size() && !unfiltered; ++offset)
+					{
+						unfiltered_processer.Clear();
+						unfiltered = unfiltered_processer.Process(scan_view, offset);
+					}
+					auto filtered = filter_processer.ScanProcess(scan_view);
+					if (!unfiltered || !IsSameAccept(filtered, unfiltered))
+						throw "Prefilter Error";
+
+					auto searched = search_processer.Search(scan_view);
+					if (!IsSameAccept(searched, unfiltered))
+						throw "Prefilter Error";
+
+					std::size_t find_count = 0;
+					std::size_t scan_count = 0;
+					for (auto& match : search_processer.FindAll(scan_view))
+						++find_count;
+					for (std::size_t offset = 0; offset <= scan_view.size();)
+					{
+						auto match = filter_processer.ScanProcess(scan_view, offset);
+						if (!match)
+							break;
+						++scan_count;
+						offset = std::max(match.GetMainCapture().End(), offset + 1);
+					}
+					if (find_count != scan_count)
+						throw "Prefilter Error";
+				}
+			}
+		}
+	}
+
+	{
+		Potato::Reg::Nfa search_nfa(u8"a([0-9]+)");
+		search_nfa.MakeUnanchored();
+		Potato::Reg::Dfa search_dfa(Dfa::FormatE::HeadMatch, search_nfa);
+		Potato::Reg::DfaProcessor search_processer;
+		search_processer.SetObserverTable(search_dfa);
+		std::u8string_view search_str = u8"a1 xa23 a b a456";
+		std::size_t count = 0;
+		for (auto& match : search_processer.FindAll(search_str))
+		{
+			auto cap = match.GetCapture(0).Slice(search_str);
+			if (count == 0 && (match.GetMainCapture().Slice(search_str) != u8"a1" || cap != u8"1"))
+				throw "FindAll Error";
+			++count;
+		}
+		if (count != 3)
+			throw "FindAll Error";
+	}
+
+	{
+		std::u8string lazy_str(1024 * 1024, u8'a');
+		lazy_str += u8"b";
+		Potato::Reg::LazyDfa lazy_dfa(Dfa::FormatE::HeadMatch, u8"(a|b)*b", false, 0, 16);
+		Potato::Reg::DfaProcessor lazy_processer;
+		lazy_processer.SetObserverTable(lazy_dfa);
+		total_index = 0;
+		auto cur1 = std::chrono::system_clock::now();
+		for (std::size_t i = 0; i < 10; ++i)
+		{
+			lazy_processer.Clear();
+			auto match = lazy_processer.Process(std::u8string_view{ lazy_str });
+			if (!match || match.GetMainCapture().End() != lazy_str.size())
+				throw "LazyDfa Error";
+			total_index += match.GetMainCapture().End();
+		}
+		auto cur2 = std::chrono::system_clock::now();
+		Potato::Log::Log<u8"Test", Potato::Log::LogLevel::Log, L" Test Lazy: {} - {} - {}">(total_index, lazy_dfa.GetStateCount(), cur2 - cur1);
+	}
+
+	{
+		// the smallest MaxStateCount, so the cache is cleared in the middle of a match
+		std::size_t clear_count = 0;
+		for (auto pattern : DiffPatterns)
+		{
+			for (auto format : { Dfa::FormatE::Match, Dfa::FormatE::HeadMatch, Dfa::FormatE::GreedyHeadMatch })
+			{
+				Potato::Reg::Dfa dfa(format, pattern);
+				Potato::Reg::LazyDfa lazy_dfa(format, pattern, false, 0, 3);
+				for (auto input : DiffInputs)
+				{
+					if (!IsSameMainProcess(dfa, lazy_dfa, input))
+						throw "LazyDfa Error";
+				}
+				clear_count += lazy_dfa.GetClearCount();
+			}
+		}
+		if (clear_count == 0)
+			throw "LazyDfa Error";
+
+		Potato::Reg::Dfa counter_dfa(Dfa::FormatE::HeadMatch, u8"x{2,5}y?");
+		Potato::Reg::LazyDfa counter_lazy_dfa(Dfa::FormatE::HeadMatch, u8"x{2,5}y?", false, 0, 3);
+		if (!IsSameMainProcess(counter_dfa, counter_lazy_dfa, std::u8string_view{ u8"xxxxxy" }) || counter_lazy_dfa.GetClearCount() == 0)
+			throw "LazyDfa Error";
+	}
+
+	{
+		Potato::Reg::Dfa batch_dfa(Dfa::FormatE::Match, u8"content-(type|length)");
+		batch_dfa.BuildUtf8Table();
+		std::vector<std::u8string_view> batch_str;
+		for (std::size_t i = 0; i < 100000; ++i)
+			batch_str.push_back((i % 3 == 0) ? u8"content-type" : ((i % 3 == 1) ? u8"content-length" : u8"host"));
+		Potato::Reg::DfaBatchProcessor batch_processer;
+		batch_processer.SetObserverTable(batch_dfa);
+		auto cur1 = std::chrono::system_clock::now();
+		auto result = batch_processer.Process(std::span<std::u8string_view const>(batch_str), 0);
+		auto cur2 = std::chrono::system_clock::now();
+		total_index = 0;
+		for (std::size_t i = 0; i < result.size(); ++i)
+		{
+			if (bool(result[i]) != (i % 3 != 2))
+				throw "Batch Error";
+			if (result[i])
+				total_index += batch_processer[i].GetCapture(0).Size();
+		}
+		Potato::Log::Log<u8"Test", Potato::Log::LogLevel::Log, L" Test Batch: {} - {}">(total_index, cur2 - cur1);
+	}
+
+	{
+		std::vector<std::u8string> long_inputs = { std::u8string(40, u8'x') + u8"y", u8"if" + std::u8string(37, u8'a'), std::u8string(50, u8'7') + u8".5" };
+		std::vector<std::u8string_view> u8_inputs;
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			u8_inputs.insert(u8_inputs.end(), DiffInputs.begin(), DiffInputs.end());
+			u8_inputs.insert(u8_inputs.end(), long_inputs.begin(), long_inputs.end());
+		}
+		std::vector<std::u32string_view> u32_inputs = {
+			U"", U"abc123 x", U"if(", U"xxxxxxy", U"foo@bar.com", U"12.5", U"ababcdà", U"été", U"中文字符abc", U"\U0001F600ab",
+			U"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxy", U"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa1", U"777777777777777777777777777777.5"
+		};
+		for (auto pattern : DiffPatterns)
+		{
+			for (auto format : { Dfa::FormatE::Match, Dfa::FormatE::HeadMatch, Dfa::FormatE::GreedyHeadMatch })
+			{
+				Potato::Reg::Dfa code_point_dfa(format, pattern);
+				code_point_dfa.BuildClassTable();
+				Potato::Reg::Dfa byte_dfa = code_point_dfa;
+				byte_dfa.BuildUtf8Table();
+				auto byte_k = Potato::Reg::CreateDfaBinaryTable(byte_dfa);
+				Potato::Reg::DfaBinaryTableWrapper byte_wrapper{ std::span(byte_k) };
+				for (std::size_t thread_count : { 1, 2 })
+				{
+					if (!IsSameBatch(code_point_dfa, u8_inputs, thread_count) || !IsSameBatch(byte_dfa, u8_inputs, thread_count) || !IsSameBatch(byte_wrapper, u8_inputs, thread_count))
+						throw "Batch Error";
+					if (!IsSameBatch(code_point_dfa, u32_inputs, thread_count) || !IsSameBatch(byte_wrapper, u32_inputs, thread_count))
+						throw "Batch Error";
+				}
+			}
+		}
+	}
+
+	{
+		using StaticTable = Potato::Reg::StaticDfaBinaryTable<u8"[0-9a-zA-Z][0-9a-zA-Z]*">;
+		static_assert(StaticTable::Available);
+		Potato::Reg::DfaBinaryTableWrapper static_wrapper{ StaticTable::Buffer };
+		Potato::Reg::DfaProcessor static_processer;
+		static_processer.SetObserverTable(static_wrapper);
+		for (std::u8string_view static_str : { u8"1234567abcdefg", u8"abc-def", u8"-abc" })
+		{
+			static_processer.Clear();
+			auto match = static_processer.Process(static_str);
+			processer.SetObserverTable(dfa);
+			processer.Clear();
+			auto match2 = processer.Process(static_str);
+			if (bool(match) != bool(match2) || (match && match.GetMainCapture() != match2.GetMainCapture()))
+				throw "StaticDfa Error";
+		}
+	}
+
+	{
+		bool same = IsSameStatic<
+			u8"[0-9a-zA-Z][0-9a-zA-Z]*", u8"if|else|while|[a-z_][a-z_0-9]*", u8"(?:[a-z]+)@(?:[a-z]+)\\.com", u8"(?:[0-9]+)\\.(?:[0-9]+)", u8"[^0-9 ]+",
+			u8"(?:ab|cd)*[à-ÿ]", u8"[一-龥]+|été", u8".*?Loc:", u8"a+?b", u8"(?:a|ab)(?:c|bcd)", u8"(?:ab)+|a", u8"[a-c]*?d?", u8"ab|abcd", u8"if|ifelse"
+		>();
+		if (!same)
+			throw "StaticDfa Error";
+		// counters and captures are out of the subset of the static builder
+		static_assert(!Potato::Reg::StaticDfaBinaryTable<u8"x{2,5}y?">::Available);
+		static_assert(!Potato::Reg::StaticDfaBinaryTable<u8"([0-9]{2,4})x">::Available);
+		static_assert(!Potato::Reg::StaticDfaBinaryTable<u8"([a-z]+)@([a-z]+)\\.com">::Available);
+		static_assert(!Potato::Reg::StaticDfaBinaryTable<u8"(a|ab)(c|bcd)">::Available);
+	}
+
+	{
+		std::u8string stream_str(1024 * 1024, u8'-');
+		stream_str += u8"a1 xa23";
+		stream_str += std::u8string(1024 * 1024, u8'-');
+		stream_str += u8"a456";
+		Potato::Reg::Nfa stream_nfa(u8"a([0-9]+)");
+		stream_nfa.MakeUnanchored();
+		Potato::Reg::Dfa stream_dfa(Dfa::FormatE::HeadMatch, stream_nfa);
+		stream_dfa.BuildUtf8Table();
+		StringStreamReader stream_reader{ stream_str };
+		Potato::Reg::DfaStreamMatcher stream_matcher(stream_reader, 4096);
+		stream_matcher.SetObserverTable(stream_dfa);
+		std::size_t count = 0;
+		while (auto match = stream_matcher.Next())
+		{
+			if (count == 0 && match.GetMainCapture().Slice(std::u8string_view{ stream_str }) != u8"a1")
+				throw "StreamMatcher Error";
+			if (stream_matcher.GetString(match.GetMainCapture()) != match.GetMainCapture().Slice(std::u8string_view{ stream_str }))
+				throw "StreamMatcher Error";
+			if (stream_matcher.GetRetainedSize() > 4096 * 2)
+				throw "StreamMatcher Error";
+			++count;
+		}
+		if (count != 3)
+			throw "StreamMatcher Error";
+	}
+
+	{
+		// the matches are longer than a block, both the byte level and the code point path have to keep them
+		std::u8string stream_str = u8"--a" + std::u8string(100, u8'7') + u8"-中a" + std::u8string(37, u8'1') + u8"中-a9";
+		Potato::Reg::Nfa stream_nfa(u8"a([0-9]+)");
+		stream_nfa.MakeUnanchored();
+		Potato::Reg::Dfa code_point_dfa(Dfa::FormatE::HeadMatch, stream_nfa);
+		Potato::Reg::Dfa byte_dfa = code_point_dfa;
+		byte_dfa.BuildUtf8Table();
+		for (auto table : { &code_point_dfa, &byte_dfa })
+		{
+			StringStreamReader stream_reader{ stream_str };
+			Potato::Reg::DfaStreamMatcher stream_matcher(stream_reader, 4);
+			stream_matcher.SetObserverTable(*table);
+			Potato::Reg::DfaProcessor processer;
+			processer.SetObserverTable(*table);
+			std::size_t count = 0;
+			std::size_t offset = 0;
+			while (auto match = stream_matcher.Next())
+			{
+				auto match2 = processer.Search(std::u8string_view{ stream_str }, offset);
+				if (!match2 || match.GetMainCapture() != match2.GetMainCapture() || match.GetCaptureSize() != 1 || match.GetCapture(0) != match2.GetCapture(0))
+					throw "StreamMatcher Error";
+				if (stream_matcher.GetString(match.GetMainCapture()) != match.GetMainCapture().Slice(std::u8string_view{ stream_str }))
+					throw "StreamMatcher Error";
+				if (stream_matcher.GetString(match.GetCapture(0)) != match.GetCapture(0).Slice(std::u8string_view{ stream_str }))
+					throw "StreamMatcher Error";
+				offset = match.GetMainCapture().End();
+				++count;
+			}
+			if (count != 3)
+				throw "StreamMatcher Error";
+		}
+	}
+
+	{
+		MulityRegCreater literal_creater;
+		literal_creater.AppendReg(u8"if", false, 1);
+		literal_creater.AppendReg(u8"int", true, 2);
+		literal_creater.AppendReg(u8"[a-z]+", false, 3);
+		literal_creater.AppendReg(u8"+=", true, 4);
+		auto literal_table = *literal_creater.CreateMulityRegTable();
+		Potato::Reg::DfaProcessor literal_processer;
+		auto match = literal_table.Process(literal_processer, u8"if(");
+		if (!match || match.GetMask() != 1 || match.GetMainCapture().End() != 2)
+			throw "LiteralTable Error";
+		match = literal_table.Process(literal_processer, u8"ifx");
+		if (!match || match.GetMask() != 3 || match.GetMainCapture().End() != 3)
+			throw "LiteralTable Error";
+		match = literal_table.Process(literal_processer, u8"+=1");
+		if (!match || match.GetMask() != 4)
+			throw "LiteralTable Error";
+	}
+
+	{
+		// the regex patterns share a mask, the literal between them has to win over the later one
+		MulityRegCreater priority_creater;
+		priority_creater.AppendReg(u8"[a-z]+", false, 1);
+		priority_creater.AppendReg(u8"12", false, 3);
+		priority_creater.AppendReg(u8"[0-9]+", false, 1);
+		priority_creater.AppendReg(u8"else", false, 4);
+		priority_creater.AppendReg(u8"[0-9]+x", false, 5);
+		priority_creater.AppendReg(u8"12x", true, 6);
+		auto priority_table = *priority_creater.CreateMulityRegTable();
+		auto priority_dfa = *priority_creater.CreateDfa(Dfa::FormatE::GreedyHeadMatch);
+		Potato::Reg::DfaProcessor priority_processer;
+		Potato::Reg::DfaProcessor dfa_processer;
+		dfa_processer.SetObserverTable(priority_dfa);
+		for (std::u8string_view input : { u8"12", u8"123", u8"else", u8"elsex", u8"12x", u8"123x", u8"x", u8"-" })
+		{
+			auto match = priority_table.Process(priority_processer, input);
+			dfa_processer.Clear();
+			auto match2 = dfa_processer.Process(input);
+			if (bool(match) != bool(match2) || (match && (match.GetMask() != match2.GetMask() || match.GetMainCapture() != match2.GetMainCapture())))
+				throw "LiteralTable Error";
+		}
+		auto match = priority_table.Process(priority_processer, u8"12");
+		if (!match || match.GetMask() != 3)
+			throw "LiteralTable Error";
+	}
+
+	{
+		Potato::Reg::Nfa capture_nfa(u8"([a-z]+)@([a-z]+)\\.com");
+		capture_nfa.RemoveCapture();
+		Potato::Reg::Dfa capture_free_dfa(Dfa::FormatE::HeadMatch, capture_nfa);
+		if (!capture_free_dfa.IsCaptureFree())
+			throw "CaptureFree Error";
+		auto capture_free_k = Potato::Reg::CreateDfaBinaryTable(capture_free_dfa);
+		Potato::Reg::DfaProcessor capture_free_processer;
+		capture_free_processer.SetObserverTable(Potato::Reg::DfaBinaryTableWrapper{ std::span(capture_free_k) });
+		auto match = capture_free_processer.Process(u8"abc@def.com");
+		if (!match || match.GetCaptureSize() != 0 || match.GetMainCapture().End() != 11)
+			throw "CaptureFree Error";
+	}
+
+	{
+		Potato::Reg::MulityRegCreater creater;
+		creater.AppendReg(u8"[a-z]+", false, 1);
+		creater.AppendReg(u8"ab", false, 2);
+		creater.AppendReg(u8"[0-9]+|a", false, 3);
+		auto match_table = creater.CreateMatchTable();
+		if (!match_table.has_value() || match_table->index() != 0)
+			throw "BitParallelNfa Error";
+		Potato::Reg::DfaProcessor bit_processer;
+		bit_processer.SetObserverTable(*match_table);
+		auto match = bit_processer.Process(u8"ab");
+		if (!match || match.GetMask() != 1 || match.GetMainCapture().End() != 2)
+			throw "BitParallelNfa Error";
+		bit_processer.Clear();
+		match = bit_processer.Process(u8"1234");
+		if (!match || match.GetMask() != 3)
+			throw "BitParallelNfa Error";
+		bit_processer.Clear();
+		if (bit_processer.Process(u8"a1"))
+			throw "BitParallelNfa Error";
+	}
+
+	{
+		std::size_t available_count = 0;
+		for (auto pattern : DiffPatterns)
+		{
+			Potato::Reg::Nfa nfa(pattern);
+			if (!Potato::Reg::BitParallelNfa::IsAvailable(nfa))
+				continue;
+			++available_count;
+			Potato::Reg::Dfa dfa(Dfa::FormatE::Match, nfa);
+			Potato::Reg::BitParallelNfa bit_nfa(nfa);
+			for (auto input : DiffInputs)
+			{
+				if (!IsSameMainProcess(dfa, bit_nfa, input))
+					throw "BitParallelNfa Error";
+			}
+		}
+		if (available_count == 0)
+			throw "BitParallelNfa Error";
+
+		// the longest literal which still fits in MaxPositionCount
+		std::u8string literal;
+		while (true)
+		{
+			std::u8string next_literal = literal + static_cast<char8_t>(u8'a' + literal.size() % 26);
+			if (!Potato::Reg::BitParallelNfa::IsAvailable(Potato::Reg::Nfa{ std::u8string_view{ next_literal + u8"|[0-9]+" } }))
+				break;
+			literal = std::move(next_literal);
+		}
+		std::u8string pattern = literal + u8"|[0-9]+";
+		Potato::Reg::Dfa dfa(Dfa::FormatE::Match, std::u8string_view{ pattern });
+		Potato::Reg::BitParallelNfa bit_nfa(std::u8string_view{ pattern });
+		if (bit_nfa.GetPositionCount() + 8 < Potato::Reg::BitParallelNfa::MaxPositionCount)
+			throw "BitParallelNfa Error";
+		std::u8string changed = literal;
+		changed[changed.size() / 2] = u8'-';
+		std::vector<std::u8string> long_inputs = { literal, literal.substr(0, literal.size() - 1), literal + u8"a", changed, u8"0123456789" };
+		for (auto& input : long_inputs)
+		{
+			if (!IsSameMainProcess(dfa, bit_nfa, std::u8string_view{ input }))
+				throw "BitParallelNfa Error";
+		}
+	}
+
+	{
+		auto container = Potato::Reg::CreateDfaBinaryContainer(Potato::Reg::Dfa{ Dfa::FormatE::HeadMatch, u8"([a-z]+)@([a-z]+)\\.com" });
+		auto container_wrapper = Potato::Reg::DfaBinaryTableWrapper::FromContainer(container, true);
+		if (!container_wrapper.has_value() || container_wrapper->GetFormat() != Dfa::FormatE::HeadMatch)
+			throw "BinaryTableContainer Error";
+		Potato::Reg::DfaProcessor container_processer;
+		container_processer.SetObserverTable(*container_wrapper);
+		auto match = container_processer.Process(u8"abc@def.com");
+		if (!match || match.GetMainCapture().End() != 11)
+			throw "BinaryTableContainer Error";
+		container[container.size() - 1] ^= 1;
+		if (Potato::Reg::DfaBinaryTableWrapper::FromContainer(container, true).has_value() || !Potato::Reg::DfaBinaryTableWrapper::FromContainer(container).has_value())
+			throw "BinaryTableContainer Error";
+	}
+
+	{
+		Potato::Reg::DfaTableCache table_cache(2);
+		auto table1 = table_cache.Get(Dfa::FormatE::HeadMatch, u8"[a-z]+");
+		auto table2 = table_cache.Get(Dfa::FormatE::HeadMatch, u8"[a-z]+");
+		if (table1.GetPointer() != table2.GetPointer() || !table1->GetWrapper().HasUtf8Table())
+			throw "DfaTableCache Error";
+		table_cache.Get(Dfa::FormatE::HeadMatch, u8"[a-z]+", false, 1);
+		table_cache.Get(Dfa::FormatE::Match, u8"[a-z]+");
+		auto statistics = table_cache.GetStatistics();
+		if (statistics.HitCount != 1 || statistics.MissCount != 3 || statistics.EvictionCount != 1 || table_cache.GetTableCount() != 2)
+			throw "DfaTableCache Error";
+		Potato::Reg::DfaProcessor cache_processer;
+		cache_processer.SetObserverTable(table1->GetWrapper());
+		auto match = cache_processer.Process(u8"abc1");
+		if (!match || match.GetMainCapture().End() != 3)
+			throw "DfaTableCache Error";
+		// evict continuously, a pattern passed as char goes through the same entry as the char8_t one
+		for (std::size_t i = 0; i < 20; ++i)
+		{
+			table_cache.Get(Dfa::FormatE::HeadMatch, (i % 3 == 0) ? u8"[0-9]+" : ((i % 3 == 1) ? u8"x+" : u8"y+"));
+			table_cache.Get(Dfa::FormatE::HeadMatch, std::string_view{ "x+" });
+		}
+		if (table_cache.GetTableCount() != 2)
+			throw "DfaTableCache Error";
+	}
+
+	{
+		Potato::Reg::MulityRegCreater creater;
+		creater.AppendReg(u8"([a-z]+)@([a-z]+)\\.com", false, 1);
+		creater.AppendReg(u8"[0-9]+", false, 2);
+		creater.AppendReg(u8"(ab)*c", false, 3);
+		auto sequence_table = Potato::Reg::CreateDfaBinaryTable(*creater.CreateDfa(Dfa::FormatE::HeadMatch));
+		auto parallel_table = Potato::Reg::CreateDfaBinaryTable(*creater.CreateDfa(Dfa::FormatE::HeadMatch, false, 4));
+		auto parallel_table2 = Potato::Reg::CreateDfaBinaryTable(*creater.CreateDfa(Dfa::FormatE::HeadMatch, false, 2));
+		if (parallel_table != parallel_table2 || parallel_table != sequence_table)
+			throw "ParallelDfa Error";
+		Potato::Reg::DfaProcessor sequence_processer;
+		Potato::Reg::DfaProcessor parallel_processer;
+		sequence_processer.SetObserverTable(Potato::Reg::DfaBinaryTableWrapper{ std::span(sequence_table) });
+		parallel_processer.SetObserverTable(Potato::Reg::DfaBinaryTableWrapper{ std::span(parallel_table) });
+		for (auto ite : { u8"abc@def.com", u8"1234", u8"ababc", u8"abd" })
+		{
+			sequence_processer.Clear();
+			parallel_processer.Clear();
+			auto match1 = sequence_processer.Process(ite);
+			auto match2 = parallel_processer.Process(ite);
+			if (static_cast<bool>(match1) != static_cast<bool>(match2) || (match1 && (match1.GetMask() != match2.GetMask() || match1.GetMainCapture() != match2.GetMainCapture())))
+				throw "ParallelDfa Error";
+		}
+	}
+
+	{
+		// wide enough frontier to start the workers, ParallelStatePerThread is 8
+		auto name = [](std::size_t index) {
+			std::u8string result;
+			for (std::size_t i = 0; i < 3; ++i, index /= 7)
+				result.push_back(static_cast<char8_t>(u8'a' + index % 7));
+			return result;
+		};
+		Potato::Reg::MulityRegCreater creater;
+		std::vector<std::u8string> inputs;
+		for (std::size_t i = 0; i < 300; ++i)
+		{
+			auto pattern = name(i) + u8"(" + name(i * 7 + 3) + u8"|[0-9]+)";
+			creater.AppendReg(std::u8string_view{ pattern }, false, i);
+			inputs.push_back(name(i) + name(i * 7 + 3));
+			inputs.push_back(name(i) + u8"42x");
+			inputs.push_back(name(i + 1) + name(i));
+		}
+		auto sequence_dfa = *creater.CreateDfa(Dfa::FormatE::HeadMatch);
+		auto parallel_table = Potato::Reg::CreateDfaBinaryTable(*creater.CreateDfa(Dfa::FormatE::HeadMatch, false, 2));
+		// the single thread construction runs the same frontier loop, so the tables are equal byte by byte
+		if (Potato::Reg::CreateDfaBinaryTable(sequence_dfa) != parallel_table)
+			throw "ParallelDfa Error";
+		for (std::size_t thread_count : { std::size_t(4), std::size_t(std::max(std::thread::hardware_concurrency(), 2u)) })
+		{
+			if (Potato::Reg::CreateDfaBinaryTable(*creater.CreateDfa(Dfa::FormatE::HeadMatch, false, thread_count)) != parallel_table)
+				throw "ParallelDfa Error";
+		}
+		Potato::Reg::DfaBinaryTableWrapper parallel_wrapper{ std::span(parallel_table) };
+		for (auto& input : inputs)
+		{
+			if (!IsSameProcess(sequence_dfa, parallel_wrapper, std::u8string_view{ input }))
+				throw "ParallelDfa Error";
+		}
+	}
+
+	{
+		auto hybrid_table = Potato::Reg::CreateHybridDfa(Dfa::FormatE::HeadMatch, Potato::Reg::Nfa{ u8"(a|b)*a[ab][ab][ab][ab][ab][ab][ab][ab]" }, 64);
+		if (hybrid_table.index() != 1)
+			throw "HybridDfa Error";
+		Potato::Reg::DfaProcessor hybrid_processer;
+		hybrid_processer.SetObserverTable(hybrid_table);
+		auto match = hybrid_processer.Process(u8"bababababab");
+		if (!match || match.GetMainCapture().End() != 10)
+			throw "HybridDfa Error";
+		auto small_table = Potato::Reg::CreateHybridDfa(Dfa::FormatE::HeadMatch, Potato::Reg::Nfa{ u8"[a-z]+" }, 64);
+		if (small_table.index() != 0)
+			throw "HybridDfa Error";
+	}
+
+	{
+		Potato::Reg::MulityRegCreater creater;
+		creater.AppendReg(u8R"(([a-z]+)@([a-z]+)\.com)", false, 1);
+		auto [search_table, reverse_table] = *creater.CreateReverseSearchDfa(Dfa::FormatE::HeadMatch);
+		if (!search_table.IsCaptureFree())
+			throw "ReverseDfa Error";
+		std::u8string_view source = u8"mail: foo@bar.com !";
+		Potato::Reg::DfaProcessor search_processer;
+		search_processer.SetObserverTable(search_table);
+		auto match = search_processer.ReverseSearch(reverse_table, source);
+		if (!match || match.GetMainCapture().Begin() != 6 || match.GetMainCapture().End() != 17)
+			throw "ReverseDfa Error";
+		auto capture_table = *creater.CreateDfa(Dfa::FormatE::HeadMatch);
+		Potato::Reg::DfaProcessor capture_processer;
+		capture_processer.SetObserverTable(capture_table);
+		auto capture = capture_processer.Process(source.substr(0, match.GetMainCapture().End()), match.GetMainCapture().Begin());
+		if (!capture || capture.GetCapture(0).Slice(source) != u8"foo" || capture.GetCapture(1).Slice(source) != u8"bar")
+			throw "ReverseDfa Error";
+		if (search_processer.ReverseSearch(reverse_table, source, 7).GetMainCapture().Begin() != 7)
+			throw "ReverseDfa Error";
+	}
+
 	std::this_thread::sleep_for(std::chrono::seconds{1});
 	
 	{
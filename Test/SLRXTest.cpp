@@ -21,7 +21,9 @@ enum class Terminal
 	Mul,
 	Dev,
 	LeftBracket,
-	RigheBracket
+	RigheBracket,
+	Semicolon,
+	Error
 };
 
 constexpr Symbol operator*(Terminal input) { return Symbol::AsTerminal(static_cast<std::size_t>(input)); }
@@ -102,7 +104,7 @@ struct StringMaker
 };
 */
 
-struct StringMaker : ProcessorOperator
+struct StringMaker
 {
 	std::any operator()(Symbol Value) {
 		return std::u8string(TerminalMapping[static_cast<Terminal>(Value.symbol)]);
@@ -118,11 +120,36 @@ struct StringMaker : ProcessorOperator
 		TotalBuffer += u8')';
 		return TotalBuffer;
 	}
+
+	std::u8string HandleValueReduce(SymbolInfo Symbol, LRXValueReduceProduction<std::u8string> Production) {
+		std::u8string TotalBuffer;
+		TotalBuffer += u8'(';
+		for (std::size_t I = 0; I < Production.Size(); ++I)
+		{
+			TotalBuffer += Production[I];
+		}
+		TotalBuffer += u8')';
+		return TotalBuffer;
+	}
 };
 
+// Run Function over LRX, LRXBinaryTableWrapper and LRXCompressedTableWrapper of Tab, all results should be the same.
+template<typename FunctionT>
+auto RunOnTables(LRX const& Tab, FunctionT&& Function, const char* Error)
+{
+	auto Buffer = LRXBinaryTableWrapper::Create(Tab);
+	auto CompressedBuffer = LRXCompressedTableWrapper::Create(Tab);
+	auto Result = Function(std::cref(Tab).get());
+	if (Function(LRXBinaryTableWrapper{ Buffer }) != Result || Function(LRXCompressedTableWrapper{ CompressedBuffer }) != Result)
+		throw Error;
+	return Result;
+}
+
 void TestTable(Symbol StartSymbol, std::vector<ProductionBuilder> Builder, std::vector<OpePriority> Ority, std::size_t MaxForwardDetect, std::span<Terminal const> Span, std::u8string_view TarStr, const char* Error)
 {
 	try {
+		auto ParallelTab = LRX::Create(StartSymbol, Builder, Ority, MaxForwardDetect, 4);
+
 		LRX Tab(
 			StartSymbol,
 			std::move(Builder),
@@ -132,44 +159,426 @@ void TestTable(Symbol StartSymbol, std::vector<ProductionBuilder> Builder, std::
 
 		StringMaker Maker;
 
-		LRXProcessor Pro;
+		auto Run = [&](auto Table) -> std::u8string {
+			LRXProcessor Pro;
+			Pro.SetObserverTable(Table, { &StringMaker::HandleReduce, &Maker });
+			for (std::size_t I = 0; I < Span.size(); ++I)
+			{
+				if (!Pro.Consume(*Span[I], { I, I + 1 }, Maker(*Span[I])))
+					throw Error;
+			}
+			if (!Pro.EndOfFile())
+				throw Error;
+			return Pro.GetData<std::u8string>();
+		};
 
-		Pro.SetObserverTable(Tab, &Maker);
+		if (RunOnTables(Tab, Run, Error) != TarStr)
+			throw Error;
+
+		if (LRXBinaryTableWrapper::Create(ParallelTab) != LRXBinaryTableWrapper::Create(Tab))
+			throw Error;
+
+		LRXProcessor Pro;
+		Pro.SetObserverTable(Tab, { &StringMaker::HandleReduce, &Maker });
+		Pro.SetSnapshotInterval(1);
 
 		for (std::size_t I = 0; I < Span.size(); ++I)
 		{
-			if(!Pro.Consume(*Span[I], {I, I + 1}, Maker(*Span[I])))
+			if (!Pro.Consume(*Span[I], { I, I + 1 }, Maker(*Span[I])))
 				throw Error;
 		}
 
-		if(!Pro.EndOfFile())
+		if (!Pro.EndOfFile())
 			throw Error;
 
-		auto P = Pro.GetData<std::u8string>();
+		Pro.GetData<std::u8string>();
+
+		for (std::size_t I = Pro.RestoreBefore(Span.size() / 2); I < Span.size(); ++I)
+		{
+			if (!Pro.Consume(*Span[I], { I, I + 1 }, Maker(*Span[I])))
+				throw Error;
+		}
 
-		if(P != TarStr)
+		if (!Pro.EndOfFile())
 			throw Error;
 
-		auto Buffer = LRXBinaryTableWrapper::Create(Tab);
+		if (Pro.GetData<std::u8string>() != TarStr)
+			throw Error;
 
+		LRXValueProcessor<std::u8string> ValuePro;
 
-		Pro.SetObserverTable(LRXBinaryTableWrapper{ Buffer }, &Maker);
-		Pro.Clear();
+		ValuePro.SetObserverTable(Tab, { &StringMaker::HandleValueReduce, &Maker });
 
 		for (std::size_t I = 0; I < Span.size(); ++I)
 		{
-			if (!Pro.Consume(*Span[I], { I, I + 1 }, Maker(*Span[I])))
+			if (!ValuePro.Consume(*Span[I], { I, I + 1 }, std::u8string(TerminalMapping[Span[I]])))
+				throw Error;
+		}
+
+		if (!ValuePro.EndOfFile())
+			throw Error;
+
+		if (ValuePro.GetData() != TarStr)
+			throw Error;
+
+		Pro.Clear();
+
+		if (!Span.empty() && Pro.Consume(*Terminal::RigheBracket, { 0, 1 }, Maker(*Terminal::RigheBracket)))
+			throw Error;
+
+	}
+	catch (Exception::Interface const&)
+	{
+		throw Error;
+	}
+}
+
+
+void TestBuiltinReduce(const char* Error)
+{
+	try {
+		LRX Tab(
+			*Noterminal::Exp,
+			{
+				{*Noterminal::Exp, {*Noterminal::Exp1}, 1, ReduceTypeE::PassThrough},
+				{*Noterminal::Exp1, {*Noterminal::Exp1, *Terminal::Add, *Noterminal::Exp2}, 2, ReduceTypeE::CollectList},
+				{*Noterminal::Exp1, {*Noterminal::Exp2}, 3, ReduceTypeE::CollectList},
+				{*Noterminal::Exp2, {*Terminal::Num}, 4, ReduceTypeE::PassThrough},
+			},
+			{}
+		);
+
+		std::vector<Terminal> Input = { Terminal::Num, Terminal::Add, Terminal::Num, Terminal::Add, Terminal::Num };
+
+		std::size_t CallbackCount = 0;
+		auto Reduce = [&](SymbolInfo Symbol, ReduceProduction Production) -> std::any { ++CallbackCount; return {}; };
+
+		auto Run = [&](auto Table) -> std::vector<std::size_t> {
+			LRXProcessor Pro;
+			Pro.SetObserverTable(Table, Reduce);
+			for (std::size_t I = 0; I < Input.size(); ++I)
+			{
+				std::any Value;
+				if (Input[I] == Terminal::Num)
+					Value = I;
+				if (!Pro.Consume(*Input[I], { I, I + 1 }, std::move(Value)))
+					throw Error;
+			}
+			if (!Pro.EndOfFile())
+				throw Error;
+			std::vector<std::size_t> Result;
+			for (auto& Ite : Pro.GetData<std::vector<std::any>>())
+				Result.push_back(std::any_cast<std::size_t>(Ite));
+			return Result;
+		};
+
+		if (RunOnTables(Tab, Run, Error) != std::vector<std::size_t>{ 0, 2, 4 } || CallbackCount != 0)
+			throw Error;
+
+		LRX Tab2(
+			*Noterminal::Exp,
+			{
+				{*Noterminal::Exp, {*Noterminal::Exp, *Terminal::Add, *Noterminal::Exp2}, 1},
+				{*Noterminal::Exp, {*Noterminal::Exp2}, 2, ReduceTypeE::PassThrough},
+				{*Noterminal::Exp2, {*Terminal::Num}, 3, ReduceTypeE::PassThrough},
+			},
+			{}
+		);
+
+		auto Sum = [&](SymbolInfo Symbol, LRXValueReduceProduction<std::size_t> Production) -> std::size_t { ++CallbackCount; return Production[0] + Production[2]; };
+
+		LRXValueProcessor<std::size_t> ValuePro;
+		ValuePro.SetObserverTable(Tab2, Sum);
+		for (std::size_t I = 0; I < Input.size(); ++I)
+		{
+			if (!ValuePro.Consume(*Input[I], { I, I + 1 }, I + 1))
+				throw Error;
+		}
+		if (!ValuePro.EndOfFile() || ValuePro.GetData() != 1 + 3 + 5 || CallbackCount != 2)
+			throw Error;
+	}
+	catch (Exception::Interface const&)
+	{
+		throw Error;
+	}
+
+	try {
+		LRX Tab(*Noterminal::Exp, { {*Noterminal::Exp, {}, 1, ReduceTypeE::PassThrough} }, {});
+		throw Error;
+	}
+	catch (Exception::WrongProduction const&)
+	{
+	}
+}
+
+void TestRecovery(const char* Error)
+{
+	try {
+		LRX Tab(
+			*Noterminal::Exp,
+			{
+				{*Noterminal::Exp, {*Noterminal::Exp, *Noterminal::Exp1}, 1, ReduceTypeE::CollectList},
+				{*Noterminal::Exp, {}, 2, ReduceTypeE::CollectList},
+				{*Noterminal::Exp1, {*Noterminal::Exp2, *Terminal::Semicolon}, 3},
+				{*Noterminal::Exp1, {*Terminal::Error, *Terminal::Semicolon}, 4},
+				{*Noterminal::Exp2, {*Noterminal::Exp2, *Terminal::Add, *Terminal::Num}, 5},
+				{*Noterminal::Exp2, {*Terminal::Num}, 6, ReduceTypeE::PassThrough},
+			},
+			{}
+		);
+
+		auto Reduce = [&](SymbolInfo Symbol, ReduceProduction Production) -> std::any {
+			switch (Production.UserMask)
+			{
+			case 3: return Production[0].Consume();
+			case 4: return std::size_t(0);
+			case 5: return Production[0].Consume<std::size_t>() + Production[2].Consume<std::size_t>();
+			default: return {};
+			}
+		};
+
+		// 1 ; 2 + + 3 ; 4 5 ; 6 ;
+		std::vector<Terminal> Input = {
+			Terminal::Num, Terminal::Semicolon, Terminal::Num, Terminal::Add, Terminal::Add, Terminal::Num, Terminal::Semicolon,
+			Terminal::Num, Terminal::Num, Terminal::Semicolon, Terminal::Num, Terminal::Semicolon
+		};
+		std::vector<std::size_t> Numbers = { 1, 0, 2, 0, 0, 3, 0, 4, 5, 0, 6, 0 };
+
+		auto Run = [&](auto Table, std::optional<Symbol> ErrorSymbol, std::span<Symbol const> Sync, std::size_t Length) -> std::vector<std::size_t> {
+			std::vector<std::size_t> ErrorTokens;
+			auto OnError = [&](SymbolInfo Value) { ErrorTokens.push_back(Value.TokenIndex.Begin()); };
+			LRXProcessor Pro;
+			Pro.SetObserverTable(Table, Reduce);
+			Pro.SetRecovery(OnError, ErrorSymbol, Sync);
+			for (std::size_t I = 0; I < Length; ++I)
+			{
+				if (!Pro.Consume(*Input[I], { I, I + 1 }, Numbers[I]))
+					throw Error;
+			}
+			if (!Pro.EndOfFile() || Pro.GetErrorCount() != ErrorTokens.size() || Pro.GetConsumedCount() != Length + 1)
+				throw Error;
+			std::vector<std::size_t> Result;
+			for (auto& Ite : Pro.GetData<std::vector<std::any>>())
+				Result.push_back(std::any_cast<std::size_t>(Ite));
+			Result.push_back(ErrorTokens.size());
+			return Result;
+		};
+
+		if (RunOnTables(Tab, [&](auto Table) { return Run(Table, *Terminal::Error, {}, Input.size()); }, Error) != std::vector<std::size_t>{ 1, 0, 0, 6, 2 })
+			throw Error;
+
+		// without error production the symbols are discarded until one can be consumed
+		std::array<Symbol, 1> Sync = { *Terminal::Semicolon };
+		if (RunOnTables(Tab, [&](auto Table) { return Run(Table, {}, Sync, Input.size()); }, Error) != std::vector<std::size_t>{ 1, 5, 4, 6, 2 })
+			throw Error;
+
+		// unexpected EndOfFile, 1 ; 2 +
+		if (RunOnTables(Tab, [&](auto Table) { return Run(Table, *Terminal::Error, {}, 4); }, Error) != std::vector<std::size_t>{ 1, 1 })
+			throw Error;
+
+		auto ValueReduce = [&](SymbolInfo Symbol, LRXValueReduceProduction<std::vector<std::size_t>> Production) -> std::vector<std::size_t> {
+			switch (Production.UserMask)
+			{
+			case 1:
+				Production[0].insert(Production[0].end(), Production[1].begin(), Production[1].end());
+				return std::move(Production[0]);
+			case 3: return std::move(Production[0]);
+			case 4: return { 0 };
+			case 5: return { Production[0][0] + Production[2][0] };
+			default: return {};
+			}
+		};
+
+		auto ValueRun = [&](auto Table) -> std::vector<std::size_t> {
+			std::size_t ErrorCount = 0;
+			auto OnError = [&](SymbolInfo Value) { ++ErrorCount; };
+			LRXValueProcessor<std::vector<std::size_t>> Pro;
+			Pro.SetObserverTable(Table, ValueReduce);
+			Pro.SetRecovery(OnError, *Terminal::Error);
+			for (std::size_t I = 0; I < Input.size(); ++I)
+			{
+				if (!Pro.Consume(*Input[I], { I, I + 1 }, { Numbers[I] }))
+					throw Error;
+			}
+			if (!Pro.EndOfFile() || Pro.GetErrorCount() != ErrorCount)
 				throw Error;
+			auto Result = std::move(Pro.GetData());
+			Result.push_back(ErrorCount);
+			return Result;
+		};
+
+		if (RunOnTables(Tab, ValueRun, Error) != std::vector<std::size_t>{ 1, 0, 0, 6, 2 })
+			throw Error;
+
+		LRXProcessor Pro;
+		Pro.SetObserverTable(Tab, Reduce);
+		if (!Pro.Consume(*Terminal::Num, { 0, 1 }, std::size_t(1)) || Pro.Consume(*Terminal::Num, { 1, 2 }, std::size_t(2)))
+			throw Error;
+	}
+	catch (Exception::Interface const&)
+	{
+		throw Error;
+	}
+}
+
+void TestParallelCreate(const char* Error)
+{
+	try {
+		for (std::size_t OperatorCount : { 4, 12, 20 })
+		{
+			// Exp := Exp Op Exp for each operator, every operator has its own priority
+			std::vector<ProductionBuilder> Builder;
+			std::vector<OpePriority> Ority;
+			for (std::size_t I = 0; I < OperatorCount; ++I)
+			{
+				auto Operator = Symbol::AsTerminal(static_cast<std::size_t>(Terminal::Error) + 1 + I);
+				Builder.push_back({ *Noterminal::Exp, {*Noterminal::Exp, Operator, *Noterminal::Exp}, I + 3 });
+				Ority.push_back({ {Operator}, I % 2 == 0 ? OpePriority::Associativity::Left : OpePriority::Associativity::Right });
+			}
+			Builder.push_back({ *Noterminal::Exp, {*Terminal::LeftBracket, *Noterminal::Exp, *Terminal::RigheBracket}, 2 });
+			Builder.push_back({ *Noterminal::Exp, {*Terminal::Num}, 1 });
+
+			auto Buffer = LRXBinaryTableWrapper::Create(LRX::Create(*Noterminal::Exp, Builder, Ority, 3, 1));
+			for (std::size_t ThreadCount : { 2, 4, 0 })
+			{
+				if (LRXBinaryTableWrapper::Create(LRX::Create(*Noterminal::Exp, Builder, Ority, 3, ThreadCount)) != Buffer)
+					throw Error;
+			}
 		}
+	}
+	catch (Exception::Interface const&)
+	{
+		throw Error;
+	}
+}
 
-		if(!Pro.EndOfFile())
+void TestRingBuffer(const char* Error)
+{
+	auto IsSame = [&](LRXRingBuffer<std::size_t> const& Buffer, std::deque<std::size_t> const& Target) {
+		if (Buffer.Size() != Target.size())
 			throw Error;
+		for (std::size_t I = 0; I < Target.size(); ++I)
+		{
+			if (Buffer[I] != Target[I])
+				throw Error;
+		}
+	};
 
-		auto P2 = Pro.GetData<std::u8string>();
+	{
+		LRXRingBuffer<std::size_t> Buffer(4);
+		std::deque<std::size_t> Target;
+		for (std::size_t I = 0; I < 4; ++I)
+		{
+			Buffer.PushBack(I);
+			Target.push_back(I);
+		}
+		Buffer.PopFront();
+		Buffer.PopFront();
+		Target.pop_front();
+		Target.pop_front();
+		// wrap around, then grow while the front is not at the start of the storage
+		for (std::size_t I = 4; I < 7; ++I)
+		{
+			Buffer.PushBack(I);
+			Target.push_back(I);
+			IsSame(Buffer, Target);
+		}
+		Buffer.PushFront(1);
+		Target.push_front(1);
+		IsSame(Buffer, Target);
+		Buffer.PopFront();
+		Target.pop_front();
+		Buffer.Reserve(32);
+		IsSame(Buffer, Target);
+		if (Buffer.PopFront() != 2)
+			throw Error;
+		Target.pop_front();
+		IsSame(Buffer, Target);
+	}
 
-		if (P2 != TarStr)
+	{
+		LRXRingBuffer<std::size_t> Buffer(4);
+		std::deque<std::size_t> Target;
+		std::size_t Seed = 1;
+		for (std::size_t I = 0; I < 2000; ++I)
+		{
+			Seed = Seed * 6364136223846793005ull + 1442695040888963407ull;
+			switch ((Seed >> 33) % 5)
+			{
+			case 0:
+			case 1:
+				Buffer.PushBack(I);
+				Target.push_back(I);
+				break;
+			case 2:
+				Buffer.PushFront(I);
+				Target.push_front(I);
+				break;
+			case 3:
+				if (!Target.empty())
+				{
+					if (Buffer.PopFront() != Target.front())
+						throw Error;
+					Target.pop_front();
+				}
+				break;
+			default:
+				if (!Target.empty())
+				{
+					Buffer.PopBack();
+					Target.pop_back();
+				}
+				break;
+			}
+			IsSame(Buffer, Target);
+		}
+		Buffer.Clear();
+		if (!Buffer.Empty())
 			throw Error;
+	}
+}
 
+void TestDeepForwardDetect(const char* Error)
+{
+	try {
+		// Exp1 := Num is only reduced after 8 more symbols, deeper than the default forward detect
+		std::vector<ProductionBuilder> Builder = {
+			{*Noterminal::Exp, {*Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Add}, 1},
+			{*Noterminal::Exp, {*Noterminal::Exp1, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num, *Terminal::Num}, 2},
+			{*Noterminal::Exp1, {*Terminal::Num}, 3},
+		};
+		std::size_t MaxForwardDetect = 8;
+		static_assert(LRX::DefaultMaxForwardDetect < 8);
+
+		LRX Tab(*Noterminal::Exp, Builder, {}, MaxForwardDetect);
+
+		auto Reduce = [&](SymbolInfo Symbol, LRXValueReduceProduction<std::size_t> Production) -> std::size_t {
+			std::size_t Value = Production.UserMask * 100;
+			for (std::size_t I = 0; I < Production.Size(); ++I)
+				Value += Production[I];
+			return Value;
+		};
+
+		auto Run = [&](auto Table, std::size_t Length) -> std::size_t {
+			LRXValueProcessor<std::size_t> Pro;
+			Pro.SetObserverTable(Table, Reduce);
+			for (std::size_t I = 0; I < Length; ++I)
+			{
+				if (!Pro.Consume(*Terminal::Num, { I, I + 1 }, 1))
+					throw Error;
+			}
+			if (Length == 8 && !Pro.Consume(*Terminal::Add, { 8, 9 }, 1))
+				throw Error;
+			if (!Pro.EndOfFile())
+				throw Error;
+			return Pro.GetData();
+		};
+
+		for (auto [Length, Target] : { std::pair<std::size_t, std::size_t>{ 8, 109 }, std::pair<std::size_t, std::size_t>{ 9, 200 + 300 + 9 } })
+		{
+			if (RunOnTables(Tab, [&](auto Table) { return Run(Table, Length); }, Error) != Target)
+				throw Error;
+		}
 	}
 	catch (Exception::Interface const&)
 	{
@@ -177,6 +586,91 @@ void TestTable(Symbol StartSymbol, std::vector<ProductionBuilder> Builder, std::
 	}
 }
 
+struct CopyCountedValue
+{
+	std::size_t Value = 0;
+	static inline std::size_t CopyCount = 0;
+
+	CopyCountedValue(std::size_t Value) : Value(Value) {}
+	CopyCountedValue(CopyCountedValue const& Other) : Value(Other.Value) { ++CopyCount; }
+	CopyCountedValue(CopyCountedValue&&) = default;
+	CopyCountedValue& operator=(CopyCountedValue const& Other) { Value = Other.Value; ++CopyCount; return *this; }
+	CopyCountedValue& operator=(CopyCountedValue&&) = default;
+};
+
+void TestSnapshot(const char* Error)
+{
+	try {
+		// right recursion, the value stack grows with the input
+		LRX Tab(
+			*Noterminal::Exp,
+			{
+				{*Noterminal::Exp, {*Terminal::Num, *Noterminal::Exp}, 1},
+				{*Noterminal::Exp, {*Terminal::Num}, 2},
+			},
+			{}
+		);
+
+		auto Reduce = [&](SymbolInfo Symbol, ReduceProduction Production) -> std::any {
+			std::size_t Value = Production[0].Consume<CopyCountedValue>().Value;
+			if (Production.UserMask == 1)
+				Value += Production[1].Consume<std::size_t>();
+			return Value;
+		};
+
+		std::size_t Length = 2000;
+		LRXProcessor Pro;
+		Pro.SetObserverTable(Tab, Reduce);
+		Pro.SetSnapshotInterval(1);
+		CopyCountedValue::CopyCount = 0;
+		for (std::size_t I = 0; I < Length; ++I)
+		{
+			if (!Pro.Consume(*Terminal::Num, { I, I + 1 }, CopyCountedValue{ I }))
+				throw Error;
+		}
+
+		// each value is copied by the snapshot which first sees it, not by every snapshot
+		if (Pro.GetSnapshots().size() != Length || CopyCountedValue::CopyCount > Length * 3)
+			throw Error;
+
+		if (!Pro.EndOfFile() || Pro.GetData<std::size_t>() != Length * (Length - 1) / 2)
+			throw Error;
+
+		for (std::size_t I = Pro.RestoreBefore(Length / 2); I < Length; ++I)
+		{
+			if (!Pro.Consume(*Terminal::Num, { I, I + 1 }, CopyCountedValue{ I }))
+				throw Error;
+		}
+
+		if (!Pro.EndOfFile() || Pro.GetData<std::size_t>() != Length * (Length - 1) / 2)
+			throw Error;
+
+		// edit the tokens from the middle and make the input longer, the reparse has to match a fresh parse of the edited tokens
+		std::size_t EditedLength = Length + 10;
+		auto Edited = [&](std::size_t I) { return I < Length / 2 ? I : I * 3; };
+
+		for (std::size_t I = Pro.RestoreBefore(Length / 2); I < EditedLength; ++I)
+		{
+			if (!Pro.Consume(*Terminal::Num, { I, I + 1 }, CopyCountedValue{ Edited(I) }))
+				throw Error;
+		}
+
+		LRXProcessor Fresh;
+		Fresh.SetObserverTable(Tab, Reduce);
+		for (std::size_t I = 0; I < EditedLength; ++I)
+		{
+			if (!Fresh.Consume(*Terminal::Num, { I, I + 1 }, CopyCountedValue{ Edited(I) }))
+				throw Error;
+		}
+
+		if (!Pro.EndOfFile() || !Fresh.EndOfFile() || Pro.GetData<std::size_t>() != Fresh.GetData<std::size_t>())
+			throw Error;
+	}
+	catch (Exception::Interface const&)
+	{
+		throw Error;
+	}
+}
 
 void TestingSLRX()
 { 
@@ -242,6 +736,18 @@ void TestingSLRX()
 		);
 	
 
+	TestBuiltinReduce("TestingSLRX : Builtin Reduce");
+
+	TestRecovery("TestingSLRX : Recovery");
+
+	TestSnapshot("TestingSLRX : Snapshot");
+
+	TestParallelCreate("TestingSLRX : Parallel Create");
+
+	TestRingBuffer("TestingSLRX : Ring Buffer");
+
+	TestDeepForwardDetect("TestingSLRX : Deep Forward Detect");
+
 	std::cout << "TestingSLRX Pass !" << std::endl;
 
 }
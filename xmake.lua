@@ -24,4 +24,10 @@ if os.scriptdir() == os.projectdir() then
             add_packages("ctre", {public = true})
         target_end()
     end
+
+    target("ZBench_Reg")
+        set_kind("binary")
+        add_files("Bench/RegBench.cpp")
+        add_deps("Potato")
+    target_end()
 end
\ No newline at end of file